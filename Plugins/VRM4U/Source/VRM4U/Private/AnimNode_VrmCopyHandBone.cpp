@@ -146,6 +146,49 @@ namespace {
 
 	};
 
+
+	// rotation from the leap reference pose to the model. skelNo 0 is left
+	FQuat GetHandDelta(const FTransform &srcRefTrans, const FTransform &dstRefTrans, const FString &BoneNameLeap, int skelNo) {
+		FQuat baseDiff = FQuat::FindBetween(srcRefTrans.GetLocation(), dstRefTrans.GetLocation());
+		//FQuat q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f);
+		FQuat q9;
+
+		auto v = srcRefTrans.GetLocation().GetSafeNormal();
+		if (skelNo == 0) {
+			if (BoneNameLeap.Find(TEXT("thumb")) >= 0) {
+				if (BoneNameLeap.Find(TEXT("meta")) < 0) {
+					q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, -3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
+				} else {
+					auto vv = srcRefTrans.GetLocation();
+					vv.Y = srcRefTrans.GetLocation().Z;
+					vv.Z = srcRefTrans.GetLocation().Y;
+
+					FQuat baseDiff2 = FQuat::FindBetween(vv, FVector(1,0,0));
+					q9 = FQuat(v, -3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
+				}
+			}else {
+				q9 = FQuat(v, 3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
+			}
+		} else {
+			if (BoneNameLeap.Find(TEXT("thumb")) >= 0) {
+				if (BoneNameLeap.Find(TEXT("meta")) < 0) {
+					q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, -3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
+				} else {
+					auto vv = srcRefTrans.GetLocation();
+					vv.X = srcRefTrans.GetLocation().X;
+					vv.Y = srcRefTrans.GetLocation().Z;
+					vv.Z = srcRefTrans.GetLocation().Y;
+
+					FQuat baseDiff2 = FQuat::FindBetween(vv, FVector(-1,0,0));
+					q9 = FQuat(FVector(0, 0, -1), -3.14f / 2.f) * FQuat(FVector(1, 0, 0), -3.14f / 2.f) * FQuat(FVector(0, 1, 0), -3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
+				}
+			} else {
+				q9 = FQuat(-v, 3.14f / 2.f) * FQuat(FVector(0, 1, 0), 3.14f) * FQuat(FVector(0, 0, 1), 3.14f) * srcRefTrans.GetRotation().Inverse();
+			}
+		}
+
+		return baseDiff * q9;
+	}
 }
 
 FAnimNode_VrmCopyHandBone::FAnimNode_VrmCopyHandBone()
@@ -165,179 +208,150 @@ void FAnimNode_VrmCopyHandBone::GatherDebugData(FNodeDebugData& DebugData)
 	ComponentPose.GatherDebugData(DebugData);
 }
 
-void FAnimNode_VrmCopyHandBone::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
+void FAnimNode_VrmCopyHandBone::BuildCache(const USkeleton *Skeleton, const FBoneContainer& RequiredBones)
 {
-	check(OutBoneTransforms.Num() == 0);
-
-	const auto dstRefSkeleton = Output.AnimInstanceProxy->GetSkeleton()->GetReferenceSkeleton();
-
-	const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
-
-	//dstRefSkeleton.GetParentIndex
-
-	TArray<FBoneTransform> tmpOutTransform;
-	tmpOutTransform.SetNum(HandBoneTableVRoid.Num());
-
-	TArray<int> boneIndexTable;
-	boneIndexTable.SetNum(HandBoneTableVRoid.Num());
-
-	auto BoneSpace = EBoneControlSpace::BCS_ParentBoneSpace;
-
-	TArray<USkeletalMeshComponent*> MeshTable = {
+	const USkeletalMeshComponent *MeshTable[] = {
 		SkeletalMeshComponentLeft,
 		SkeletalMeshComponentRight,
 	};
 
+	bCacheDirty = false;
+	CacheMeta = VrmMetaObject;
+	CacheSkeleton = Skeleton;
+	for (int skelNo = 0; skelNo < 2; ++skelNo) {
+		CacheSrcMesh[skelNo] = MeshTable[skelNo] ? MeshTable[skelNo]->SkeletalMesh : nullptr;
+	}
+	BoneCache.Reset();
+
+	const auto &dstRefSkeleton = Skeleton->GetReferenceSkeleton();
+	const auto &dstRefSkeletonTransform = dstRefSkeleton.GetRefBonePose();
+
 	for (int i = 0; i < HandBoneTableVRM.Num(); ++i) {
 
 		FString BoneNameModel = HandBoneTableVRoid[i];
-		FString BoneNameLeap = HandBoneTableLeap[i];
+		const FString &BoneNameLeap = HandBoneTableLeap[i];
 
 		if (VrmMetaObject) {
-			FString *s = VrmMetaObject->humanoidBoneTable.Find(HandBoneTableVRM[i]);
+			const FString *s = VrmMetaObject->humanoidBoneTable.Find(HandBoneTableVRM[i]);
 			if (s) {
 				BoneNameModel = *s;
 			}
 		}
 
-		boneIndexTable[i] = -1;
-		int skelNo = -1;
-		for (auto SkeletalMeshComponent : MeshTable) {
-			skelNo++;
+		FVrmCopyHandBoneCache c;
+		c.dstIndex = dstRefSkeleton.FindBoneIndex(*BoneNameModel);
+		if (c.dstIndex < 0) {
+			continue;
+		}
+		c.compactIndex = RequiredBones.GetCompactPoseIndexFromSkeletonIndex(c.dstIndex);
+		if (c.compactIndex == INDEX_NONE) {
+			continue;
+		}
 
-			if (SkeletalMeshComponent == nullptr) {
+		bool bSource = false;
+		for (int skelNo = 0; skelNo < 2; ++skelNo) {
+			const USkeletalMesh *srcMesh = CacheSrcMesh[skelNo];
+			if (srcMesh == nullptr) {
 				continue;
 			}
-
-			const auto &dstRefSkeletonTransform = dstRefSkeleton.GetRefBonePose();
-			const auto &srcRefSkeletonTransform = SkeletalMeshComponent->SkeletalMesh->RefSkeleton.GetRefBonePose();
-
-			const auto srcIndex = SkeletalMeshComponent->GetBoneIndex(*BoneNameLeap);
-			const auto dstIndex = dstRefSkeleton.FindBoneIndex(*BoneNameModel);
-
-			if (srcIndex < 0 || dstIndex < 0) {
+			const auto &srcRefSkeleton = srcMesh->RefSkeleton;
+			const int32 srcIndex = srcRefSkeleton.FindBoneIndex(*BoneNameLeap);
+			if (srcIndex < 0) {
 				continue;
 			}
+			c.srcIndex[skelNo] = srcIndex;
+			c.srcParentIndex[skelNo] = srcRefSkeleton.GetParentIndex(srcIndex);
+			c.q[skelNo] = GetHandDelta(srcRefSkeleton.GetRefBonePose()[srcIndex], dstRefSkeletonTransform[c.dstIndex], BoneNameLeap, skelNo);
+			bSource = true;
+		}
+		if (bSource) {
+			BoneCache.Add(c);
+		}
+	}
 
-			const auto& srcCurrentTrans = SkeletalMeshComponent->GetSocketTransform(*BoneNameLeap, RTS_ParentBoneSpace);
-
-			const auto& srcRefTrans = srcRefSkeletonTransform[srcIndex];
-			const auto& dstRefTrans = dstRefSkeletonTransform[dstIndex];
-
-			FCompactPoseBoneIndex CompactPoseBoneToModify(dstIndex);
-
-			//auto a = srcCurrentTrans;
-			FTransform NewBoneTM = Output.Pose.GetComponentSpaceTransform(CompactPoseBoneToModify);
-			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, NewBoneTM, CompactPoseBoneToModify, BoneSpace);
-
-			FQuat baseDiff = FQuat::FindBetween(srcRefTrans.GetLocation(), dstRefTrans.GetLocation());
-			//FQuat q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f);
-			FQuat q9;
-			
-			auto v = srcRefTrans.GetLocation().GetSafeNormal();
-			if (skelNo == 0) {
-				if (BoneNameLeap.Find(TEXT("thumb")) >= 0) {
-					if (BoneNameLeap.Find(TEXT("meta")) < 0) {
-						q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, -3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
-					} else {
-						auto vv = srcRefTrans.GetLocation();
-						vv.Y = srcRefTrans.GetLocation().Z;
-						vv.Z = srcRefTrans.GetLocation().Y;
-
-						FQuat baseDiff2 = FQuat::FindBetween(vv, FVector(1,0,0));
-						q9 = FQuat(v, -3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-					}
-				}else {
-					q9 = FQuat(v, 3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
-				}
-			} else {
-				if (BoneNameLeap.Find(TEXT("thumb")) >= 0) {
-					if (BoneNameLeap.Find(TEXT("meta")) < 0) {
-						//q9 = srcRefTrans.GetRotation().Inverse();
-						q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, -3.14f / 2.f) * srcRefTrans.GetRotation().Inverse();
-					} else {
-						//q9 = FQuat(-v, 3.14f) * srcRefTrans.GetRotation().Inverse();
-
-						auto vv = srcRefTrans.GetLocation();
-						vv.X = srcRefTrans.GetLocation().X;
-						vv.Y = srcRefTrans.GetLocation().Z;
-						vv.Z = srcRefTrans.GetLocation().Y;
-
-						FQuat baseDiff2 = FQuat::FindBetween(vv, FVector(-1,0,0));
-						auto tt = srcRefTrans;
-						tt.SetLocation(vv);
-						//q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-						//q9 = FQuat(FVector(0, 0, -1), -3.14f / 2.f) * FQuat(FVector(1, 0, 0), -3.14f / 2.f) * FQuat(FVector(0, 1, 0), -3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-						q9 = FQuat(FVector(0, 0, -1), -3.14f / 2.f) * FQuat(FVector(1, 0, 0), -3.14f / 2.f) * FQuat(FVector(0, 1, 0), -3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-						//q9.X *= -1.f;
-						//q9.Y *= -1.f;
-						//q9.Z *= -1.f;
-
-
-/*
-auto vv = srcRefTrans.GetLocation();
-vv.X = -srcRefTrans.GetLocation().X;
-vv.Y = srcRefTrans.GetLocation().Z;
-vv.Z = srcRefTrans.GetLocation().Y;
-
-FQuat baseDiff2 = FQuat::FindBetween(vv, FVector(1,0,0));
-//q9 = FQuat(FVector(1, 0, 0), 3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-q9 = FQuat(FVector(1, 0, 0), -3.14f / 2.f) * FQuat(FVector(0, 1, 0), -3.14f / 2.f) * FQuat(v, 3.14f / 2.f) * baseDiff2.Inverse() * srcRefTrans.GetRotation().Inverse();
-*/
-					}
-				} else {
-					q9 = FQuat(-v, 3.14f / 2.f) * FQuat(FVector(0, 1, 0), 3.14f) * FQuat(FVector(0, 0, 1), 3.14f) * srcRefTrans.GetRotation().Inverse();
-				}
-			}
-
-			FQuat q = baseDiff * q9;
-			//FQuat q = FQuat::FindBetween(srcRefTrans.GetLocation(), dstRefTrans.GetLocation());
-
-			//NewBoneTM.SetRotation(q*FQuat(FVector(1, 0, 0), 3.14f / 2.f) * srcCurrentTrans.GetRotation() * FQuat(FVector(-1, 0, 0), 3.14f / 2.f));
-			//NewBoneTM.SetRotation(FQuat(FVector(1, 0, 0), 3.14f / 2.f) * srcCurrentTrans.GetRotation() * FQuat(FVector(-1, 0, 0), 3.14f / 2.f));
-
-			NewBoneTM.SetRotation(q * srcCurrentTrans.GetRotation() * q.Inverse());
-
-			//NewBoneTM.SetRotation(q9 * baseDiff*srcCurrentTrans.GetRotation() * baseDiff.Inverse() * q9.Inverse());
-			//NewBoneTM.SetRotation(q9 * baseDiff*srcCurrentTrans.GetRotation() * q9.Inverse());
-
+	// parents first
+	BoneCache.Sort([](const FVrmCopyHandBoneCache &a, const FVrmCopyHandBoneCache &b) {
+		return a.compactIndex.GetInt() < b.compactIndex.GetInt();
+	});
+	for (auto &c : BoneCache) {
+		const int32 parentBoneIndex = dstRefSkeleton.GetParentIndex(c.dstIndex);
+		c.parentInCache = BoneCache.IndexOfByPredicate([parentBoneIndex](const FVrmCopyHandBoneCache &p) {
+			return p.dstIndex == parentBoneIndex;
+		});
+	}
+}
 
-			//NewBoneTM.SetLocation(dstRefTrans.GetLocation());
+void FAnimNode_VrmCopyHandBone::EvaluateSkeletalControl_AnyThread(FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms)
+{
+	check(OutBoneTransforms.Num() == 0);
 
-			//NewBoneTM.SetLocation(NewBoneTM.GetLocation() );
-			//NewBoneTM.SetLocation(NewBoneTM.GetRotation() * dstRefTrans.GetLocation() );
-			//NewBoneTM.SetLocation(dstRefTrans.GetLocation());
-			//a.SetLocation(dstRefTrans.GetLocation());
+	const USkeleton *Skeleton = Output.AnimInstanceProxy->GetSkeleton();
+	if (Skeleton == nullptr) {
+		return;
+	}
 
-			//FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, a, CompactPoseBoneToModify, EBoneControlSpace::BCS_ParentBoneSpace);
+	const USkeletalMeshComponent *MeshTable[] = {
+		SkeletalMeshComponentLeft,
+		SkeletalMeshComponentRight,
+	};
 
-			//OutBoneTransforms.Insert
-			tmpOutTransform[i] = FBoneTransform(CompactPoseBoneToModify, NewBoneTM);
-			boneIndexTable[i] = dstIndex;
-			break;
+	{
+		bool bDirty = bCacheDirty || CacheMeta != VrmMetaObject || CacheSkeleton != Skeleton;
+		for (int skelNo = 0; skelNo < 2; ++skelNo) {
+			const USkeletalMesh *srcMesh = MeshTable[skelNo] ? MeshTable[skelNo]->SkeletalMesh : nullptr;
+			bDirty |= (CacheSrcMesh[skelNo] != srcMesh);
+		}
+		if (bDirty) {
+			BuildCache(Skeleton, Output.Pose.GetPose().GetBoneContainer());
 		}
 	}
-	{
-		tmpOutTransform.Sort(FCompareBoneTransformIndex());
-		//tmpOutTransform.Sort([](const FBoneTransform& x, const FBoneTransform& y) { return x.BoneIndex.GetInt() < y.BoneIndex.GetInt(); });
 
-		boneIndexTable.Sort();
-		for (int i=0; i<tmpOutTransform.Num(); ++i){
-			if (boneIndexTable[i] < 0) {
+	const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
+	auto BoneSpace = EBoneControlSpace::BCS_ParentBoneSpace;
+
+	OutBoneTransforms.Reserve(BoneCache.Num());
+	for (const auto &c : BoneCache) {
+		const FTransform *srcCurrentTrans = nullptr;
+		FTransform srcLocal;
+		int skelNo = 0;
+		for (; skelNo < 2; ++skelNo) {
+			if (MeshTable[skelNo] == nullptr || c.srcIndex[skelNo] < 0) {
 				continue;
 			}
-			auto &a = tmpOutTransform[i];
+			// parent bone space
+			const auto &srcPose = MeshTable[skelNo]->GetComponentSpaceTransforms();
+			if (srcPose.IsValidIndex(c.srcIndex[skelNo]) == false) {
+				continue;
+			}
+			srcLocal = srcPose[c.srcIndex[skelNo]];
+			if (srcPose.IsValidIndex(c.srcParentIndex[skelNo])) {
+				srcLocal.SetToRelativeTransform(srcPose[c.srcParentIndex[skelNo]]);
+			}
+			srcCurrentTrans = &srcLocal;
+			break;
+		}
 
-			int parentBoneIndex = dstRefSkeleton.GetParentIndex(boneIndexTable[i]);
+		FBoneTransform a;
+		a.BoneIndex = c.compactIndex;
+		if (srcCurrentTrans) {
+			FTransform NewBoneTM = Output.Pose.GetComponentSpaceTransform(c.compactIndex);
+			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, NewBoneTM, c.compactIndex, BoneSpace);
+
+			const FQuat &q = c.q[skelNo];
+			NewBoneTM.SetRotation(q * srcCurrentTrans->GetRotation() * q.Inverse());
+			a.Transform = NewBoneTM;
+		} else {
+			// no source this frame. keep the pose
+			a.Transform = Output.Pose.GetComponentSpaceTransform(c.compactIndex);
+			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, a.Transform, c.compactIndex, BoneSpace);
+		}
 
-			int parentInHandTable = boneIndexTable.Find(parentBoneIndex);
-			if (parentInHandTable >= 0) {
-				a.Transform *= tmpOutTransform[parentInHandTable].Transform;
-			}else {
-				FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, a.Transform, a.BoneIndex, BoneSpace);
-			}
-			OutBoneTransforms.Add(a);
+		if (c.parentInCache >= 0) {
+			a.Transform *= OutBoneTransforms[c.parentInCache].Transform;
+		} else {
+			FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, a.Transform, a.BoneIndex, BoneSpace);
 		}
+		OutBoneTransforms.Add(a);
 	}
 }
 
@@ -351,4 +365,7 @@ bool FAnimNode_VrmCopyHandBone::IsValidToEvaluate(const USkeleton* Skeleton, con
 void FAnimNode_VrmCopyHandBone::InitializeBoneReferences(const FBoneContainer& RequiredBones) 
 {
 	//BoneToModify.Initialize(RequiredBones);
+
+	// compact indices changed. the source pins may not be set yet, resolved on the next evaluation
+	bCacheDirty = true;
 }
@@ -33,80 +33,88 @@ SOFTWARE.
 #include "AnimationRuntime.h"
 #include "Animation/AnimInstanceProxy.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "Async/ParallelFor.h"
+#include "Kismet/GameplayStatics.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Misc/ScopeLock.h"
+#include "Engine/World.h"
+#include "WorldCollision.h"
 
 #include "VrmMetaObject.h"
+#include "VrmRuntimeSettings.h"
+#include "VrmSpringBoneScheduler.h"
+#include "VrmSpringBoneSolver.h"
 #include "VrmUtil.h"
 
 #include <algorithm>
 /////////////////////////////////////////////////////
 // FAnimNode_ModifyBone
 
-namespace {
-	int32 GetDirectChildBonesLocal(FReferenceSkeleton &refs, int32 ParentBoneIndex, TArray<int32> & Children)
-	{
-		Children.Reset();
-
-		const int32 NumBones = refs.GetNum();
-		for (int32 ChildIndex = ParentBoneIndex + 1; ChildIndex < NumBones; ChildIndex++)
-		{
-			if (ParentBoneIndex == refs.GetParentIndex(ChildIndex))
-			{
-				Children.Add(ChildIndex);
-			}
-		}
-
-		return Children.Num();
-	}
-
-}
+using namespace VRMSpringSolver;
 
 
 namespace VRMSpring {
 
 	class VRMSpring;
-	class VRMSpringColliderGroup;
-
-	class VRMSpringManager {
-	public:
-
-		bool bInit = false;
-		USkeletalMesh *skeletalMesh = nullptr;
 
-		void init(const UVrmMetaObject *meta, FComponentSpacePoseContext& Output);
-		void update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms);
-		void reset();
+	////
+	// immutable data. built once per meta object and skeleton, shared by all instances
 
-		TArray<VRMSpring> spring;
-		TArray<VRMSpringColliderGroup> colliderGroup;
+	// joint data of all chains. flat arrays
+	class VRMSpringJointSetting {
+	public:
+		TArray<FName> boneName;
+		TArray<int32> boneIndex;
+		TArray<int32> parentJoint;			// INDEX_NONE for chain root
+		TArray<int32> chainIndex;			// VRMSpringSetting::chain
+		TArray<FTransform> refLocal;
+		TArray<FVector> m_boneAxis;
+		TArray<float> m_length;
+
+		int32 Num() const {
+			return boneIndex.Num();
+		}
+		int32 Add(const FName &name, int32 bone, int32 parent, int32 chain) {
+			boneName.Add(name);
+			parentJoint.Add(parent);
+			chainIndex.Add(chain);
+			refLocal.Add(FTransform::Identity);
+			m_boneAxis.Add(FVector::ForwardVector);
+			m_length.Add(1.f);
+			return boneIndex.Add(bone);
+		}
 	};
 
-	class VRMSpringCollider {
+	class VRMSpringChain {
 	public:
-		FVector offset = FVector::ZeroVector;
-		float radius = 0.f;
+		int32 start = 0;
+		int32 num = 0;
+		float reach = 0.f;		// sum of joint length
 	};
-	class VRMSpringColliderGroup {
+
+	// collider spheres of all groups
+	class VRMSpringColliderSetting {
 	public:
-		int node = 0;
-		FName node_name;
+		TArray<FVector> offset;		// bone local, unreal scale
+		TArray<float> radius;		// unreal scale
 
-		TArray<VRMSpringCollider> colliders;
+		int32 Num() const {
+			return offset.Num();
+		}
 	};
 
-	class VRMSprintData {
+	class VRMSpringColliderGroupSetting {
 	public:
-		int boneIndex = -1;
-		FName boneName;
-		FVector m_currentTail = FVector::ZeroVector;
-		FVector m_prevTail = FVector::ZeroVector;
-		FTransform m_transform = FTransform::Identity;
-		FVector m_boneAxis = FVector::ForwardVector;
-		float m_length = 1.f;
-
-		FQuat m_resultQuat = FQuat::Identity;
+		int node = 0;
+		FName node_name;
+		int32 boneIndex = INDEX_NONE;
+
+		// range in VRMSpringColliderSetting
+		int32 sphereStart = 0;
+		int32 sphereNum = 0;
 	};
 
-	class VRMSpring {
+	class VRMSpringSetting {
 	public:
 		float stiffness = 0.f;
 		float gravityPower = 0.f;
@@ -122,330 +130,1101 @@ namespace VRMSpring {
 		//int* colliderGroups = nullptr;
 		TArray<int> ColliderGroupIndexArray;
 
+		TArray<VRMSpringChain> chain;
+		TArray<TArray<int32>> jointByDepth;
+	};
+
+	class VRMSpringTemplate {
+	public:
+		TArray<VRMSpringSetting> spring;
+		TArray<VRMSpringColliderGroupSetting> colliderGroup;
+		VRMSpringColliderSetting collider;
+		VRMSpringJointSetting joint;
+
+		void build(const UVrmMetaObject *meta, const USkeleton *skeleton);
+
+		static TSharedPtr<const VRMSpringTemplate, ESPMode::ThreadSafe> Get(const UVrmMetaObject *meta, const USkeleton *skeleton);
+	};
 
-		TArray< TArray<VRMSprintData> > SpringDataChain;
-		TArray<VRMSprintData> RootSpringData;
+	////
+	// per instance. dynamic state only
 
-		USkeletalMesh *skeletalMesh = nullptr;
-		~VRMSpring() {
-			skeletalMesh = nullptr;
+	class VRMSpringJointArray {
+	public:
+		TArray<FCompactPoseBoneIndex> compactIndex;
+		TArray<FVector> m_currentTail;
+		TArray<FVector> m_prevTail;
+		TArray<FTransform> m_transform;		// component space, rotation is m_resultQuat
+		TArray<FQuat> m_resultQuat;
+		TArray<FQuat> m_prevResultQuat;		// one simulation step before
+		TArray<FQuat> m_outputQuat;			// interpolated for output
+		TArray<FTransform> m_outputTransform;	// component space output
+		TArray<uint8> m_active;				// root bone is in the pose
+		TArray<FTransform> m_rootPose;		// component space input pose. chain root only
+
+		int32 Num() const {
+			return compactIndex.Num();
+		}
+		void Reset() {
+			compactIndex.Reset();
+			m_currentTail.Reset();
+			m_prevTail.Reset();
+			m_transform.Reset();
+			m_resultQuat.Reset();
+			m_prevResultQuat.Reset();
+			m_outputQuat.Reset();
+			m_outputTransform.Reset();
+			m_active.Reset();
+			m_rootPose.Reset();
+		}
+		void Init(int32 num) {
+			compactIndex.Init(FCompactPoseBoneIndex(INDEX_NONE), num);
+			m_currentTail.Init(FVector::ZeroVector, num);
+			m_prevTail.Init(FVector::ZeroVector, num);
+			m_transform.Init(FTransform::Identity, num);
+			m_resultQuat.Init(FQuat::Identity, num);
+			m_prevResultQuat.Init(FQuat::Identity, num);
+			m_outputQuat.Init(FQuat::Identity, num);
+			m_outputTransform.Init(FTransform::Identity, num);
+			m_active.Init(1, num);
+			m_rootPose.Init(FTransform::Identity, num);
 		}
+	};
 
-		void Update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FTransform center,
+	// collider state. sphere center and group bounds are updated once per frame
+	class VRMSpringColliderArray {
+	public:
+		TArray<FVector> center;		// component space, per sphere
+		TArray<FVector> prevCenter;	// last frame
+
+		// per group
+		TArray<FCompactPoseBoneIndex> compactIndex;
+		TArray<uint8> bValid;
+		TArray<FVector> boundCenter;	// bounding sphere of all colliders
+		TArray<float> boundRadius;
+
+		void Reset() {
+			center.Reset();
+			prevCenter.Reset();
+			compactIndex.Reset();
+			bValid.Reset();
+			boundCenter.Reset();
+			boundRadius.Reset();
+		}
+		void Init(int32 sphereNum, int32 groupNum) {
+			center.Init(FVector::ZeroVector, sphereNum);
+			prevCenter.Init(FVector::ZeroVector, sphereNum);
+			compactIndex.Init(FCompactPoseBoneIndex(INDEX_NONE), groupNum);
+			bValid.Init(0, groupNum);
+			boundCenter.Init(FVector::ZeroVector, groupNum);
+			boundRadius.Init(0.f, groupNum);
+		}
+	};
+
+	// batched physics collision.
+	// requests are recorded during evaluation and issued from the game thread in PreUpdate.
+	// results are applied once they come back, a frame after the query runs.
+	class VRMSpringPhysicsQuery {
+	public:
+		struct FRequest {
+			int32 joint = INDEX_NONE;
+			FVector start = FVector::ZeroVector;
+			float radius = 0.f;
+			int32 objectMask = 0;
+		};
+		struct FHit {
+			FVector normal = FVector::ZeroVector;
+			float distance = 0.f;
+		};
+
+		TArray<FRequest> pending;		// issued, waiting for the result
+		TArray<FTraceHandle> handle;	// same order as pending
+
+		TArray<int32> hitStart;			// per joint
+		TArray<int32> hitNum;			// per joint
+		TArray<FHit> hit;
+
+		void Reset() {
+			pending.Reset();
+			handle.Reset();
+			hitStart.Reset();
+			hitNum.Reset();
+			hit.Reset();
+		}
+	};
+
+	// everything the solver reads from the anim node and the pose. captured at evaluation
+	class VRMSpringSolveParam {
+	public:
+		float DeltaTime = 0.f;
+		FTransform ComponentTransform = FTransform::Identity;
+		USkeletalMeshComponent *WorldContext = nullptr;
+
+		int loopc = 1;
+		float gravityScale = 1.f;
+		FVector gravityAdd = FVector::ZeroVector;
+		float stiffnessScale = 1.f;
+		float stiffnessAdd = 0.f;
+		bool bIgnorePhysicsCollision = false;
+		bool bAsyncPhysicsCollision = false;
+		bool bIgnoreVRMCollision = false;
+
+		// fixed timestep. step count of this frame and interpolation between the last two steps
+		bool bFixedTimestep = false;
+		int fixedStepNum = 0;
+		float fixedStepDelta = 0.f;
+		float interpAlpha = 1.f;
+
+		// LOD
+		bool bSkip = false;
+		int maxDepth = 0;
+
+		// chain sleep. 0 disables
+		int sleepFrame = 0;
+		float sleepVelocity = 0.f;
+		float sleepRootRotation = 0.f;
+	};
+
+	class VRMSpringManager {
+	public:
+
+		bool bInit = false;
+
+		// scheduler. solved by FVrmSpringBoneScheduler instead of the anim node.
+		// registered again when the scheduler of the world is replaced
+		bool bScheduled = false;
+		int32 schedulerSerial = 0;
+		bool bSolved = false;
+		FCriticalSection SolveLock;
+
+		// fixed timestep
+		float timeAccumulator = 0.f;
+
+		// solve cost for the LOD budget. added from solver threads
+		volatile int32 solveCycles = 0;
+
+		void init(const UVrmMetaObject *meta, FComponentSpacePoseContext& Output);
+		void update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms);
+		void capture(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output);
+		void solveSpring(int32 i);
+		void warmStart(FComponentSpacePoseContext& Output);
+		void reset();
+		void resolveCompactIndex(const FBoneContainer &RequiredBones);
+		void updateCollider(FComponentSpacePoseContext& Output);
+		void updatePhysicsQuery(UWorld *world, const AActor *ignoreActor);
+		void updateOutput();
+		void output(int32 boneNum, TArray<FBoneTransform>& OutBoneTransforms);
+
+		TSharedPtr<const VRMSpringTemplate, ESPMode::ThreadSafe> tmpl;
+		// UVrmMetaObject::SpringBakeVersion of tmpl
+		int32 tmplVersion = 0;
+
+		// index ordered output. per compact pose bone
+		TBitArray<> outputBit;
+		TArray<FTransform> outputBuffer;
+
+		TArray<VRMSpring> spring;
+		VRMSpringColliderArray collider;
+		VRMSpringJointArray joint;
+		VRMSpringPhysicsQuery physicsQuery;
+		VRMSpringSolveParam param;
+	};
+
+	class VRMSpring {
+	public:
+		const VRMSpringSetting *setting = nullptr;
+		int32 physicsObjectMask = 0;
+
+		// colliders near each chain. updated once per frame
+		TArray<TArray<int32>> colliderCandidate;
+
+		// batched physics collision. recorded while solving
+		TArray<VRMSpringPhysicsQuery::FRequest> physicsRequest;
+
+		// chain sleep. per chain
+		TArray<int32> sleepCounter;			// frames at rest
+		TArray<uint8> bSleep;
+		TArray<FTransform> sleepRootPose;	// world space, last frame
+		TArray<int32> sleepCandidateNum;	// colliderCandidate of the last frame
+		TArray<TArray<int32>> awakeJointByDepth;	// jointByDepth without sleeping chains
+
+		void InitSleep();
+		const TArray<TArray<int32>> &UpdateSleep(const VRMSpringTemplate &tmpl,
+			const VRMSpringSolveParam &param,
+			const VRMSpringColliderArray &collider,
+			VRMSpringJointArray &joint,
+			const VRMSpringPhysicsQuery &physics);
+		void UpdateSleepCounter(const VRMSpringSolveParam &param, const VRMSpringJointArray &joint, float stepDeltaTime);
+		void UpdateOutput(const VRMSpringTemplate &tmpl, VRMSpringJointArray &joint) const;
+
+		void Update(const VRMSpringTemplate &tmpl,
+			const VRMSpringSolveParam &param,
 			//float stiffnessForce, float dragForce, FVector external,
 			//int colliders,
-			const TArray<VRMSpringColliderGroup> &colliderGroup,
-			FComponentSpacePoseContext& Output);
+			const VRMSpringColliderArray &collider,
+			VRMSpringJointArray &joint,
+			const VRMSpringPhysicsQuery &physics);
+
+		FVector Collide(const VRMSpringTemplate &tmpl, const VRMSpringSolveParam &param, const FTransform &center,
+			const VRMSpringColliderArray &collider, int32 chainIndex,
+			const VRMSpringPhysicsQuery &physics, int32 j, bool bRecord,
+			const FVector &head, float length, FVector nextTail);
 	};
 
-	void VRMSpring::Update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FTransform center,
-		const TArray<VRMSpringColliderGroup> &colliderGroup,
-		FComponentSpacePoseContext& Output) {
+	void VRMSpringTemplate::build(const UVrmMetaObject *meta, const USkeleton *skeleton) {
+		// chains are baked at import. older assets are baked here
+		FVRMSpringBake localBake;
+		const FVRMSpringBake *bake = &meta->VRMSpringBake;
+		if (meta->IsSpringBoneBaked() == false) {
+			UVrmMetaObject::BakeSpringBone(meta->SkeletalMesh->RefSkeleton, meta->VRMSpringMeta, localBake);
+			bake = &localBake;
+		}
+
+		// pose bones are indexed by the skeleton
+		const FReferenceSkeleton &PoseRefSkeleton = skeleton->GetReferenceSkeleton();
+		const auto &PoseRefSkeletonTransform = PoseRefSkeleton.GetRefBonePose();
+
+		spring.SetNum(meta->VRMSpringMeta.Num());
+
+		for (int i = 0; i < spring.Num(); ++i) {
+			auto &s = spring[i];
+			const auto &metaS = meta->VRMSpringMeta[i];
+
+			s.stiffness = metaS.stiffness;
+			s.gravityPower = metaS.gravityPower;
+			s.gravityDir = metaS.gravityDir;
+			s.dragForce = metaS.dragForce;
+			s.hitRadius = metaS.hitRadius;
+
+			const int32 chainStart = bake->springChainStart[i];
+			const int32 chainNum = bake->springChainNum[i];
+
+			s.chain.Reset(chainNum);
+			for (int bc = chainStart; bc < chainStart + chainNum; ++bc) {
+				VRMSpringChain c;
+				c.start = joint.Num();
+
+				int32 parent = INDEX_NONE;
+				for (int bj = bake->chainJointStart[bc]; bj < bake->chainJointStart[bc] + bake->chainJointNum[bc]; ++bj) {
+					const FName &boneName = bake->jointBoneName[bj];
+					const int32 poseBoneIndex = PoseRefSkeleton.FindBoneIndex(boneName);
+					if (poseBoneIndex == INDEX_NONE) {
+						break;
+					}
+
+					const int32 j = joint.Add(boneName, poseBoneIndex, parent, s.chain.Num());
+					joint.refLocal[j] = PoseRefSkeletonTransform[poseBoneIndex];
+					joint.m_boneAxis[j] = bake->jointBoneAxis[bj];
+					joint.m_length[j] = bake->jointLength[bj];
+					parent = j;
+				}
+
+				c.num = joint.Num() - c.start;
+				for (int j = c.start; j < c.start + c.num; ++j) {
+					c.reach += joint.m_length[j];
+				}
+				if (c.num > 0) {
+					s.chain.Add(c);
+				}
+			}
+
+			s.jointByDepth.Reset();
+			for (const auto &c : s.chain) {
+				if (s.jointByDepth.Num() < c.num) {
+					s.jointByDepth.SetNum(c.num);
+				}
+				for (int d = 0; d < c.num; ++d) {
+					s.jointByDepth[d].Add(c.start + d);
+				}
+			}
+
+			s.ColliderGroupIndexArray.SetNum(metaS.ColliderIndexArray.Num());
+			for (int c = 0; c < s.ColliderGroupIndexArray.Num(); ++c) {
+				s.ColliderGroupIndexArray[c] = metaS.ColliderIndexArray[c];
+			}
+
+		}
+
+		// collider
+		colliderGroup.SetNum(meta->VRMColliderMeta.Num());
+		for (int i=0; i<colliderGroup.Num(); ++i){
+			auto &cg = colliderGroup[i];
+			const auto &cmeta = meta->VRMColliderMeta[i];
 
-		if (skeletalMesh == nullptr) {
+			cg.node = cmeta.bone;
+			cg.node_name = *cmeta.boneName;
+			cg.boneIndex = PoseRefSkeleton.FindBoneIndex(cg.node_name);
+
+			cg.sphereStart = collider.Num();
+			cg.sphereNum = cmeta.collider.Num();
+			for (const auto &c : cmeta.collider) {
+				auto offs = c.offset;
+				offs.Set(-offs.X, offs.Z, offs.Y);
+				collider.offset.Add(offs * 100.f);
+				collider.radius.Add(c.radius * 100.f);
+			}
+		}
+	}
+
+	TSharedPtr<const VRMSpringTemplate, ESPMode::ThreadSafe> VRMSpringTemplate::Get(const UVrmMetaObject *meta, const USkeleton *skeleton) {
+		struct FEntry {
+			TWeakObjectPtr<const UVrmMetaObject> meta;
+			TWeakObjectPtr<const USkeleton> skeleton;
+			int32 version;
+			TSharedPtr<const VRMSpringTemplate, ESPMode::ThreadSafe> tmpl;
+		};
+		static TArray<FEntry> cache;
+		static FCriticalSection cacheLock;
+
+		FScopeLock lock(&cacheLock);
+
+		for (int i = cache.Num() - 1; i >= 0; --i) {
+			const auto &e = cache[i];
+			if (e.meta.IsValid() == false || e.skeleton.IsValid() == false) {
+				cache.RemoveAtSwap(i);
+				continue;
+			}
+			if (e.meta.Get() == meta && e.skeleton.Get() == skeleton) {
+				if (e.version == meta->SpringBakeVersion) {
+					return e.tmpl;
+				}
+				// rebaked. instances holding the old one keep it until they reset
+				cache.RemoveAtSwap(i);
+			}
+		}
+
+		TSharedPtr<VRMSpringTemplate, ESPMode::ThreadSafe> t = MakeShareable(new VRMSpringTemplate());
+		t->build(meta, skeleton);
+		cache.Add({ meta, skeleton, meta->SpringBakeVersion, t });
+		return t;
+	}
+
+	void VRMSpring::Update(const VRMSpringTemplate &tmpl,
+		const VRMSpringSolveParam &param,
+		const VRMSpringColliderArray &collider,
+		VRMSpringJointArray &joint,
+		const VRMSpringPhysicsQuery &physics) {
+
+		physicsRequest.Reset();
+
+		if (setting == nullptr || param.bSkip) {
 			return;
 		}
+		const auto &s = *setting;
+		const auto &js = tmpl.joint;
 
-		const auto RefSkeleton = Output.AnimInstanceProxy->GetSkeleton()->GetReferenceSkeleton();
-		const auto &RefSkeletonTransform = RefSkeleton.GetRefBonePose();
+		const auto &jointByDepth = UpdateSleep(tmpl, param, collider, joint, physics);
 
-		const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
-		center = ComponentTransform.Inverse();
+		const float DeltaTime = param.DeltaTime;
+		const FTransform center = param.ComponentTransform.Inverse();
+
+		const bool bSIMD = GetDefault<UVrmRuntimeSettings>()->bSpringBoneSIMD;
 
 		//
 		// x10 adjust?
-		FVector ue4grav(-gravityDir.X, gravityDir.Z, gravityDir.Y);
+		FVector ue4grav(-s.gravityDir.X, s.gravityDir.Z, s.gravityDir.Y);
 
-		const int MAX_LOOP = FMath::Max(1, animNode->loopc);
+		int MAX_LOOP = FMath::Max(1, param.loopc);
+		if (param.bFixedTimestep) {
+			MAX_LOOP = param.fixedStepNum;
+		}
 		for (int i = 0; i < MAX_LOOP; ++i) {
 			//const float stiffnessForce = stiffness * DeltaTime * 10.f * animNode->stiffnessScale + animNode->stiffinessAdd;
 			//FVector external = center.TransformVector(ue4grav) * (gravityPower * DeltaTime) * animNode->gravityScale + center.TransformVector(animNode->gravityAdd) * DeltaTime;
 			//external *= 100.f; // to unreal scale
 
 			float CurrentDeltaTime = DeltaTime / (float)MAX_LOOP;
+			if (param.bFixedTimestep) {
+				CurrentDeltaTime = param.fixedStepDelta;
+			}
 
-			const float stiffnessForce = stiffness * CurrentDeltaTime * 10.f * animNode->stiffnessScale + animNode->stiffnessAdd;
-			FVector external = center.TransformVector(ue4grav) * (gravityPower * CurrentDeltaTime) * animNode->gravityScale + center.TransformVector(animNode->gravityAdd) * CurrentDeltaTime;
-			external *= 100.f; // to unreal scale
-
-
-			const auto WorldContext = Output.AnimInstanceProxy->GetSkelMeshComponent();
+			for (const auto &c : s.chain) {
+				for (int j = c.start; j < c.start + c.num; ++j) {
+					joint.m_prevResultQuat[j] = joint.m_resultQuat[j];
+				}
+			}
 
-			for (int springCount = 0; springCount < SpringDataChain.Num(); ++springCount) {
+			const float stiffnessForce = s.stiffness * CurrentDeltaTime * 10.f * param.stiffnessScale + param.stiffnessAdd;
+			FVector external = center.TransformVector(ue4grav) * (s.gravityPower * CurrentDeltaTime) * param.gravityScale + center.TransformVector(param.gravityAdd) * CurrentDeltaTime;
+			external *= 100.f; // to unreal scale
 
-				auto &ChainRoot = SpringDataChain[springCount];
-				FTransform currentTransform = FTransform::Identity;
 
-				for (int chainCount = 0; chainCount < ChainRoot.Num(); ++chainCount) {
+			// children depend on the parent joint only. solve depth by depth across chains
+			for (int d = 0; d < jointByDepth.Num(); ++d) {
+				if (param.maxDepth > 0 && d >= param.maxDepth) {
+					break;
+				}
+				const auto &depth = jointByDepth[d];
+				for (int batch = 0; batch < depth.Num(); batch += SpringLaneNum) {
+					const int laneNum = FMath::Min(SpringLaneNum, depth.Num() - batch);
+
+					FSpringLane L;
+					int32 laneJoint[SpringLaneNum];
+					FQuat laneRotation[SpringLaneNum];
+
+					// gather
+					for (int lane = 0; lane < SpringLaneNum; ++lane) {
+						// unused lanes repeat the first joint
+						const int32 j = depth[batch + (lane < laneNum ? lane : 0)];
+						laneJoint[lane] = j;
+
+						const int32 parent = js.parentJoint[j];
+						FTransform &currentTransform = joint.m_transform[j];
+						if (parent == INDEX_NONE) {
+							currentTransform = joint.m_rootPose[j];
+						} else {
+							joint.m_active[j] = joint.m_active[parent];
+							currentTransform = js.refLocal[j] * joint.m_transform[parent];
+						}
 
-					auto &sData = ChainRoot[chainCount];
+						FQuat m_localRotation = FQuat::Identity;
+						const FQuat ParentRotation = currentTransform.GetRotation();
+						laneRotation[lane] = ParentRotation * m_localRotation;
 
-					FVector currentTail = center.TransformPosition(sData.m_currentTail);
-					FVector prevTail = center.TransformPosition(sData.m_prevTail);
+						L.SetCur(lane, center.TransformPosition(joint.m_currentTail[j]));
+						L.SetPrev(lane, center.TransformPosition(joint.m_prevTail[j]));
+						L.SetHead(lane, currentTransform.GetLocation());
+						// 親の回転による子ボーンの移動目標
+						L.SetAxis(lane, laneRotation[lane] * js.m_boneAxis[j]);
+						L.length[lane] = js.m_length[j];
+					}
 
-					int myBoneIndex = RefSkeleton.FindBoneIndex(sData.boneName);
-					if (myBoneIndex < 0) {
-						continue;
+					// verlet積分で次の位置を計算
+					// 長さをboneLengthに強制
+					if (bSIMD) {
+						SpringVerletSIMD(L, s.dragForce, stiffnessForce, external);
+					} else {
+						SpringVerletScalar(L, SpringLaneNum, s.dragForce, stiffnessForce, external);
 					}
 
-					int myParentBoneIndex = RefSkeleton.GetParentIndex(myBoneIndex);
+					FSpringRotLane R;
+					for (int lane = 0; lane < SpringLaneNum; ++lane) {
+						const int32 j = laneJoint[lane];
+						const FVector head(L.headX[lane], L.headY[lane], L.headZ[lane]);
+						const float length = js.m_length[j];
+						FVector nextTail = L.GetNext(lane);
 
-					//currentTransform = FTransform::Identity;
-					FQuat ParentRotation = FQuat::Identity;
-					if (chainCount == 0) {
-						FCompactPoseBoneIndex uu(myBoneIndex);
-						FTransform NewBoneTM = Output.Pose.GetComponentSpaceTransform(uu);
-						ParentRotation = NewBoneTM.GetRotation();
+						if (lane < laneNum && joint.m_active[j]) {
+							// Collisionで移動
+							nextTail = Collide(tmpl, param, center, collider, js.chainIndex[j], physics, j, i == MAX_LOOP - 1, head, length, nextTail);
 
-						currentTransform = NewBoneTM;
-					} else {
-						auto c = RefSkeletonTransform[sData.boneIndex];
-						auto t = c * currentTransform;
+							joint.m_prevTail[j] = center.InverseTransformPosition(FVector(L.curX[lane], L.curY[lane], L.curZ[lane]));
+							joint.m_currentTail[j] = center.InverseTransformPosition(nextTail);
+						}
 
-						ParentRotation = t.GetRotation();
-						currentTransform = t;
+						const FVector a = (laneRotation[lane] * js.m_boneAxis[j]).GetSafeNormal();
+						const FVector b = (nextTail - head).GetSafeNormal();
+						R.aX[lane] = a.X; R.aY[lane] = a.Y; R.aZ[lane] = a.Z;
+						R.bX[lane] = b.X; R.bY[lane] = b.Y; R.bZ[lane] = b.Z;
 					}
-					FQuat m_localRotation = FQuat::Identity;
 
+					const int validMask = bSIMD ? SpringFindBetweenSIMD(R) : 0;
 
-					// verlet積分で次の位置を計算
-					FVector nextTail = currentTail
-						+ (currentTail - prevTail) * (1.0f - dragForce) // 前フレームの移動を継続する(減衰もあるよ)
-						+ ParentRotation * m_localRotation * sData.m_boneAxis * stiffnessForce // 親の回転による子ボーンの移動目標
-						+ external // 外力による移動量
-						;
+					// scatter
+					for (int lane = 0; lane < laneNum; ++lane) {
+						const int32 j = laneJoint[lane];
+						if (joint.m_active[j] == 0) {
+							continue;
+						}
 
-					// 長さをboneLengthに強制
-					//nextTail = sData.m_transform.GetLocation() + (nextTail - sData.m_transform.GetLocation()).GetSafeNormal() * sData.m_length;
-					nextTail = currentTransform.GetLocation() + (nextTail - currentTransform.GetLocation()).GetSafeNormal() * sData.m_length;
-
-					// Collisionで移動
-
-					// vrm <-> physics collision
-					if (animNode->bIgnorePhysicsCollision == false) {
-						FVector Start = center.InverseTransformPosition(nextTail);
-						FVector End = Start + FVector(0.001f);
-						//* WorldContextObject
-						float Radius = hitRadius * 100.f;
-						ETraceTypeQuery TraceChannel = ETraceTypeQuery::TraceTypeQuery1;
-						bool bTraceComplex = false;
-
-						TArray<AActor*> ActorsToIgnore;
-						EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None;
-						TArray<FHitResult> OutHits;
-						bool bIgnoreSelf = true;
-						FLinearColor TraceColor;
-						FLinearColor TraceHitColor;
-						float DrawTime = 0.f;
-
-						bool b = UKismetSystemLibrary::SphereTraceMulti(WorldContext, Start, End, hitRadius * 100.f,
-							TraceChannel, false, ActorsToIgnore,
-							DrawDebugType,
-							OutHits, bIgnoreSelf, TraceColor, TraceHitColor, DrawTime);
-						if (b) {
-							for (auto hit : OutHits) {
-								{
-									//WorldContext->GetOwner
-									//hit.BoneName
-
-								}
-								float r = hitRadius * 100.f + hit.Distance;
-								auto normal = hit.Normal;
-								auto posFromCollider = nextTail + normal * (r);
-								// 長さをboneLengthに強制
-								nextTail = currentTransform.GetLocation() + (posFromCollider - currentTransform.GetLocation()).GetSafeNormal() * sData.m_length;
-							}
+						FQuat q;
+						if (validMask & (1 << lane)) {
+							q = FQuat(R.qX[lane], R.qY[lane], R.qZ[lane], R.qW[lane]);
+						} else {
+							q = FQuat::FindBetween(FVector(R.aX[lane], R.aY[lane], R.aZ[lane]), FVector(R.bX[lane], R.bY[lane], R.bZ[lane]));
 						}
+						joint.m_resultQuat[j] = q * laneRotation[lane];
+						joint.m_transform[j].SetRotation(joint.m_resultQuat[j]);
 					}
+				}
+			}// depth loop
+		}// delta time loop
+
+		if (MAX_LOOP > 0) {
+			UpdateSleepCounter(param, joint, param.bFixedTimestep ? param.fixedStepDelta : DeltaTime / (float)MAX_LOOP);
+		}
+
+		for (const auto &c : s.chain) {
+			for (int j = c.start; j < c.start + c.num; ++j) {
+				if (param.bFixedTimestep) {
+					joint.m_outputQuat[j] = FQuat::Slerp(joint.m_prevResultQuat[j], joint.m_resultQuat[j], param.interpAlpha);
+				} else {
+					joint.m_outputQuat[j] = joint.m_resultQuat[j];
+				}
+			}
+		}
+		UpdateOutput(tmpl, joint);
+	}
+
+	void VRMSpring::UpdateOutput(const VRMSpringTemplate &tmpl, VRMSpringJointArray &joint) const {
+		const auto &js = tmpl.joint;
+		for (const auto &c : setting->chain) {
+			for (int j = c.start; j < c.start + c.num; ++j) {
+				const int32 parent = js.parentJoint[j];
+				FTransform &t = joint.m_outputTransform[j];
+				if (parent == INDEX_NONE) {
+					t = joint.m_rootPose[j];
+				} else {
+					t = js.refLocal[j] * joint.m_outputTransform[parent];
+				}
+				t.SetRotation(joint.m_outputQuat[j]);
+			}
+		}
+	}
 
-					// vrm <-> vrm collision
-					if (animNode->bIgnoreVRMCollision == false) {
-						for (auto ind : ColliderGroupIndexArray) {
-							const auto &cg = colliderGroup[ind];
+	void VRMSpring::InitSleep() {
+		const int32 chainNum = setting->chain.Num();
+		sleepCounter.Init(0, chainNum);
+		bSleep.Init(0, chainNum);
+		sleepRootPose.Init(FTransform::Identity, chainNum);
+		sleepCandidateNum.Init(0, chainNum);
+		awakeJointByDepth.Reset();
+	}
 
-							int ii = RefSkeleton.FindBoneIndex(cg.node_name);
-							if (ii < 0) {
-								continue;
-							}
+	const TArray<TArray<int32>> &VRMSpring::UpdateSleep(const VRMSpringTemplate &tmpl,
+		const VRMSpringSolveParam &param,
+		const VRMSpringColliderArray &collider,
+		VRMSpringJointArray &joint,
+		const VRMSpringPhysicsQuery &physics) {
 
-							//FCompactPoseBoneIndex uu(cg.node);
-							FCompactPoseBoneIndex uu(ii);
-							FTransform collisionBoneTrans = Output.Pose.GetComponentSpaceTransform(uu);
+		const auto &s = *setting;
 
-							for (auto c : cg.colliders) {
+		if (param.sleepFrame <= 0) {
+			for (int ci = 0; ci < s.chain.Num(); ++ci) {
+				sleepCounter[ci] = 0;
+				bSleep[ci] = 0;
+			}
+			return s.jointByDepth;
+		}
 
+		const float maxMove = param.sleepVelocity * param.DeltaTime;
+		// sync physics collision has no contact info. keep awake
+		const bool bSyncPhysics = (param.bIgnorePhysicsCollision == false && param.bAsyncPhysicsCollision == false);
 
-								float r = (hitRadius + c.radius) * 100.f;
-								//FVector v = collisionBoneTrans.TransformPosition(c.offset*100);
-								auto offs = c.offset;
-								offs.Set(-offs.X, offs.Z, offs.Y);
-								offs *= 100;
-								FVector v = collisionBoneTrans.TransformPosition(offs);
+		bool bAnySleep = false;
+		for (int ci = 0; ci < s.chain.Num(); ++ci) {
+			const auto &c = s.chain[ci];
+			bool bWake = bSyncPhysics;
 
-								if ((v - nextTail).SizeSquared() > r * r) {
-									continue;
-								}
+			// root moved
+			const FTransform rootPose = joint.m_rootPose[c.start] * param.ComponentTransform;
+			if (FVector::DistSquared(rootPose.GetLocation(), sleepRootPose[ci].GetLocation()) > FMath::Square(maxMove)) {
+				bWake = true;
+			}
+			if (FMath::RadiansToDegrees(rootPose.GetRotation().AngularDistance(sleepRootPose[ci].GetRotation())) > param.sleepRootRotation) {
+				bWake = true;
+			}
+			sleepRootPose[ci] = rootPose;
 
-								// ヒット。Colliderの半径方向に押し出す
-								auto normal = (nextTail - v).GetSafeNormal();
-								auto posFromCollider = v + normal * (r);
-								// 長さをboneLengthに強制
-								nextTail = currentTransform.GetLocation() + (posFromCollider - currentTransform.GetLocation()).GetSafeNormal() * sData.m_length;
-							}
-						}
+			// collider came near or moved
+			if (param.bIgnoreVRMCollision == false) {
+				if (colliderCandidate[ci].Num() != sleepCandidateNum[ci]) {
+					bWake = true;
+				}
+				sleepCandidateNum[ci] = colliderCandidate[ci].Num();
+				for (const int32 i : colliderCandidate[ci]) {
+					if ((collider.center[i] - collider.prevCenter[i]).SizeSquared() > FMath::Square(maxMove)) {
+						bWake = true;
+						break;
 					}
+				}
+			}
 
-					sData.m_prevTail = center.InverseTransformPosition(currentTail);
-					sData.m_currentTail = center.InverseTransformPosition(nextTail);
+			// physics contact
+			if (param.bIgnorePhysicsCollision == false && param.bAsyncPhysicsCollision) {
+				for (int j = c.start; j < c.start + c.num; ++j) {
+					if (physics.hitNum.IsValidIndex(j) && physics.hitNum[j] > 0) {
+						bWake = true;
+						break;
+					}
+				}
+			}
 
-					FQuat rotation = ParentRotation * m_localRotation;
+			if (bWake) {
+				// -1. this frame does not count as rest
+				sleepCounter[ci] = -1;
+				bSleep[ci] = 0;
+			} else if (bSleep[ci] == 0 && sleepCounter[ci] >= param.sleepFrame) {
+				// stop without velocity
+				bSleep[ci] = 1;
+				for (int j = c.start; j < c.start + c.num; ++j) {
+					joint.m_prevTail[j] = joint.m_currentTail[j];
+					joint.m_prevResultQuat[j] = joint.m_outputQuat[j] = joint.m_resultQuat[j];
+				}
+			}
+			bAnySleep |= (bSleep[ci] != 0);
+		}
 
-					sData.m_resultQuat = FQuat::FindBetween((rotation * sData.m_boneAxis).GetSafeNormal(),
-						(nextTail - currentTransform.GetLocation()).GetSafeNormal()) * rotation;
+		if (bAnySleep == false) {
+			return s.jointByDepth;
+		}
 
-					currentTransform.SetRotation(sData.m_resultQuat);
+		awakeJointByDepth.SetNum(s.jointByDepth.Num());
+		for (int d = 0; d < s.jointByDepth.Num(); ++d) {
+			auto &depth = awakeJointByDepth[d];
+			depth.Reset();
+			for (const int32 j : s.jointByDepth[d]) {
+				if (bSleep[tmpl.joint.chainIndex[j]] == 0) {
+					depth.Add(j);
 				}
-			}// chain loop
-		}// delta time loop
+			}
+		}
+		return awakeJointByDepth;
+	}
+
+	void VRMSpring::UpdateSleepCounter(const VRMSpringSolveParam &param, const VRMSpringJointArray &joint, float stepDeltaTime) {
+		if (param.sleepFrame <= 0) {
+			return;
+		}
+		const float maxMove = param.sleepVelocity * stepDeltaTime;
+
+		for (int ci = 0; ci < setting->chain.Num(); ++ci) {
+			if (bSleep[ci]) {
+				continue;
+			}
+			const auto &c = setting->chain[ci];
+
+			// tail movement of the last step
+			bool bRest = true;
+			for (int j = c.start; j < c.start + c.num; ++j) {
+				if ((joint.m_currentTail[j] - joint.m_prevTail[j]).SizeSquared() > FMath::Square(maxMove)) {
+					bRest = false;
+					break;
+				}
+			}
+			sleepCounter[ci] = bRest ? sleepCounter[ci] + 1 : 0;
+		}
+	}
+
+	FVector VRMSpring::Collide(const VRMSpringTemplate &tmpl, const VRMSpringSolveParam &param, const FTransform &center,
+		const VRMSpringColliderArray &collider, int32 chainIndex,
+		const VRMSpringPhysicsQuery &physics, int32 j, bool bRecord,
+		const FVector &head, float length, FVector nextTail) {
+
+		const float hitRadius = setting->hitRadius;
+
+		// vrm <-> physics collision, batched
+		if (param.bIgnorePhysicsCollision == false && param.bAsyncPhysicsCollision) {
+			if (physicsObjectMask == 0) {
+				// this spring does not collide
+			} else {
+				if (physics.hitNum.IsValidIndex(j)) {
+					for (int h = physics.hitStart[j]; h < physics.hitStart[j] + physics.hitNum[j]; ++h) {
+						const auto &hit = physics.hit[h];
+						float r = hitRadius * 100.f + hit.distance;
+						auto posFromCollider = nextTail + center.TransformVectorNoScale(hit.normal) * (r);
+						// 長さをboneLengthに強制
+						nextTail = head + (posFromCollider - head).GetSafeNormal() * length;
+					}
+				}
+				if (bRecord) {
+					auto &req = physicsRequest.AddDefaulted_GetRef();
+					req.joint = j;
+					req.start = center.InverseTransformPosition(nextTail);
+					req.radius = hitRadius * 100.f;
+					req.objectMask = physicsObjectMask;
+				}
+			}
+		} else
+
+		// vrm <-> physics collision
+		if (param.bIgnorePhysicsCollision == false) {
+			FVector Start = center.InverseTransformPosition(nextTail);
+			FVector End = Start + FVector(0.001f);
+			//* WorldContextObject
+			float Radius = hitRadius * 100.f;
+			ETraceTypeQuery TraceChannel = ETraceTypeQuery::TraceTypeQuery1;
+			bool bTraceComplex = false;
+
+			TArray<AActor*> ActorsToIgnore;
+			EDrawDebugTrace::Type DrawDebugType = EDrawDebugTrace::None;
+			TArray<FHitResult> OutHits;
+			bool bIgnoreSelf = true;
+			FLinearColor TraceColor;
+			FLinearColor TraceHitColor;
+			float DrawTime = 0.f;
+
+			bool b = UKismetSystemLibrary::SphereTraceMulti(param.WorldContext, Start, End, hitRadius * 100.f,
+				TraceChannel, false, ActorsToIgnore,
+				DrawDebugType,
+				OutHits, bIgnoreSelf, TraceColor, TraceHitColor, DrawTime);
+			if (b) {
+				for (auto hit : OutHits) {
+					{
+						//WorldContext->GetOwner
+						//hit.BoneName
+
+					}
+					float r = hitRadius * 100.f + hit.Distance;
+					auto normal = hit.Normal;
+					auto posFromCollider = nextTail + normal * (r);
+					// 長さをboneLengthに強制
+					nextTail = head + (posFromCollider - head).GetSafeNormal() * length;
+				}
+			}
+		}
+
+		// vrm <-> vrm collision
+		if (param.bIgnoreVRMCollision == false) {
+			for (const int32 ci : colliderCandidate[chainIndex]) {
+				nextTail = SpringCollideSphere(head, length, nextTail, collider.center[ci], hitRadius * 100.f + tmpl.collider.radius[ci]);
+			}
+		}
+		return nextTail;
 	}
 
 	void VRMSpringManager::reset() {
+		FScopeLock lock(&SolveLock);
+		bScheduled = false;
+		bSolved = false;
+		timeAccumulator = 0.f;
+		tmpl.Reset();
 		spring.Empty();
+		joint.Reset();
+		collider.Reset();
+		physicsQuery.Reset();
 		bInit = false;
 	}
+	void VRMSpringManager::resolveCompactIndex(const FBoneContainer &RequiredBones) {
+		if (tmpl.IsValid() == false) {
+			return;
+		}
+		for (int j = 0; j < joint.Num(); ++j) {
+			joint.compactIndex[j] = RequiredBones.GetCompactPoseIndexFromSkeletonIndex(tmpl->joint.boneIndex[j]);
+		}
+		for (int i = 0; i < tmpl->colliderGroup.Num(); ++i) {
+			const int32 boneIndex = tmpl->colliderGroup[i].boneIndex;
+			collider.compactIndex[i] = FCompactPoseBoneIndex(INDEX_NONE);
+			if (boneIndex != INDEX_NONE) {
+				collider.compactIndex[i] = RequiredBones.GetCompactPoseIndexFromSkeletonIndex(boneIndex);
+			}
+		}
+	}
 	void VRMSpringManager::init(const UVrmMetaObject *meta, FComponentSpacePoseContext& Output) {
 		if (meta == nullptr) return;
 		if (bInit) return;
 
-		skeletalMesh = meta->SkeletalMesh;
-		const FReferenceSkeleton &RefSkeleton = skeletalMesh->RefSkeleton;
-		const auto &RefSkeletonTransform = RefSkeleton.GetRefBonePose();
-
-		spring.SetNum(meta->VRMSpringMeta.Num());
+		tmpl = VRMSpringTemplate::Get(meta, Output.AnimInstanceProxy->GetSkeleton());
+		tmplVersion = meta->SpringBakeVersion;
 
+		spring.SetNum(tmpl->spring.Num());
 		for (int i = 0; i < spring.Num(); ++i) {
-			auto &s = spring[i];
-			const auto &metaS = meta->VRMSpringMeta[i];
+			spring[i].setting = &tmpl->spring[i];
+			spring[i].colliderCandidate.SetNum(tmpl->spring[i].chain.Num());
+			spring[i].InitSleep();
+		}
+		joint.Init(tmpl->joint.Num());
+		collider.Init(tmpl->collider.Num(), tmpl->colliderGroup.Num());
 
-			s.skeletalMesh = meta->SkeletalMesh;
+		resolveCompactIndex(Output.Pose.GetPose().GetBoneContainer());
 
-			s.stiffness = metaS.stiffness;
-			s.gravityPower = metaS.gravityPower;
-			s.gravityDir = metaS.gravityDir;
-			s.dragForce = metaS.dragForce;
-			s.hitRadius = metaS.hitRadius;
+		// init default transform
+		for (int j = 0; j < joint.Num(); ++j) {
+			if (joint.compactIndex[j] == INDEX_NONE) {
+				continue;
+			}
+			FTransform t = Output.Pose.GetComponentSpaceTransform(joint.compactIndex[j]);
+			joint.m_transform[j] = t;
+			joint.m_currentTail[j] = joint.m_prevTail[j] = t.TransformPosition(tmpl->joint.m_boneAxis[j]);
+		}
 
-			s.RootSpringData.SetNum(metaS.bones.Num());
-			for (int scount = 0; scount < s.RootSpringData.Num(); ++scount) {
-				s.RootSpringData[scount].boneName = *metaS.boneNames[scount];
-				s.RootSpringData[scount].boneIndex = RefSkeleton.FindBoneIndex(*metaS.boneNames[scount]);
+		bInit = true;
+	}
+	void VRMSpringManager::updateCollider(FComponentSpacePoseContext& Output) {
+		for (int g = 0; g < tmpl->colliderGroup.Num(); ++g) {
+			const auto &cg = tmpl->colliderGroup[g];
+			collider.bValid[g] = (collider.compactIndex[g] != INDEX_NONE && cg.sphereNum > 0);
+			if (collider.bValid[g] == 0) {
+				continue;
 			}
-			// TODO add child
 
-			s.SpringDataChain.SetNum(metaS.bones.Num());
-			for (int scount = 0; scount < s.RootSpringData.Num(); ++scount) {
-				auto &chain = s.SpringDataChain[scount];
+			const FTransform collisionBoneTrans = Output.Pose.GetComponentSpaceTransform(collider.compactIndex[g]);
 
-				//root
-				{
-					auto &sData = chain.AddDefaulted_GetRef();
-					sData.boneName = *metaS.boneNames[scount];
-					sData.boneIndex = skeletalMesh->RefSkeleton.FindBoneIndex(*metaS.boneNames[scount]);
+			FVector sum = FVector::ZeroVector;
+			for (int i = cg.sphereStart; i < cg.sphereStart + cg.sphereNum; ++i) {
+				collider.prevCenter[i] = collider.center[i];
+				collider.center[i] = collisionBoneTrans.TransformPosition(tmpl->collider.offset[i]);
+				sum += collider.center[i];
+			}
+			const FVector boundCenter = sum / (float)cg.sphereNum;
+			float boundRadius = 0.f;
+			for (int i = cg.sphereStart; i < cg.sphereStart + cg.sphereNum; ++i) {
+				boundRadius = FMath::Max(boundRadius, (collider.center[i] - boundCenter).Size() + tmpl->collider.radius[i]);
+			}
+			collider.boundCenter[g] = boundCenter;
+			collider.boundRadius[g] = boundRadius;
+		}
 
-					TArray<int32> Children;
-					GetDirectChildBonesLocal(skeletalMesh->RefSkeleton, sData.boneIndex, Children);
-					if (Children.Num() > 0) {
-						sData.m_boneAxis = RefSkeletonTransform[Children[0]].GetLocation();
-					} else {
-						sData.m_boneAxis = RefSkeletonTransform[sData.boneIndex].GetLocation() * 0.7f;
+		// broadphase. chain tails stay within reach from the chain root
+		for (auto &s : spring) {
+			for (int ci = 0; ci < s.setting->chain.Num(); ++ci) {
+				const auto &c = s.setting->chain[ci];
+				auto &candidate = s.colliderCandidate[ci];
+				candidate.Reset();
+				if (joint.compactIndex[c.start] == INDEX_NONE) {
+					continue;
+				}
+				const FVector root = Output.Pose.GetComponentSpaceTransform(joint.compactIndex[c.start]).GetLocation();
+				const float chainRadius = c.reach + s.setting->hitRadius * 100.f;
+
+				for (auto ind : s.setting->ColliderGroupIndexArray) {
+					if (tmpl->colliderGroup.IsValidIndex(ind) == false) {
+						continue;
+					}
+					if (collider.bValid[ind] == 0) {
+						continue;
+					}
+					if ((collider.boundCenter[ind] - root).SizeSquared() > FMath::Square(chainRadius + collider.boundRadius[ind])) {
+						continue;
+					}
+					const auto &cg = tmpl->colliderGroup[ind];
+					for (int i = cg.sphereStart; i < cg.sphereStart + cg.sphereNum; ++i) {
+						if ((collider.center[i] - root).SizeSquared() > FMath::Square(chainRadius + tmpl->collider.radius[i])) {
+							continue;
+						}
+						candidate.Add(i);
 					}
 				}
+			}
+		}
+	}
 
-				// child
-				if (1) {
-					for (int chainCount = 0; chainCount < 100; ++chainCount) {
-						bool bLast = false;
-						TArray<int32> Children;
+	void VRMSpringManager::updatePhysicsQuery(UWorld *world, const AActor *ignoreActor) {
+		auto &q = physicsQuery;
+
+		// results of the last issued requests
+		q.hitStart.Init(0, joint.Num());
+		q.hitNum.Init(0, joint.Num());
+		q.hit.Reset();
+		for (int i = 0; i < q.pending.Num(); ++i) {
+			const int32 j = q.pending[i].joint;
+			if (joint.m_active.IsValidIndex(j) == false) {
+				continue;
+			}
+			FTraceDatum datum;
+			if (world == nullptr || world->QueryTraceData(q.handle[i], datum) == false) {
+				continue;
+			}
+			q.hitStart[j] = q.hit.Num();
+			for (const auto &h : datum.OutHits) {
+				auto &hit = q.hit.AddDefaulted_GetRef();
+				hit.normal = h.Normal;
+				hit.distance = h.Distance;
+			}
+			q.hitNum[j] = q.hit.Num() - q.hitStart[j];
+		}
+		q.pending.Reset();
+		q.handle.Reset();
 
-						GetDirectChildBonesLocal(skeletalMesh->RefSkeleton, chain[chainCount].boneIndex, Children);
-						if (Children.Num() <= 0) {
-							break;
-						}
+		if (world == nullptr) {
+			return;
+		}
+
+		// issue all joint spheres. the engine runs them together in one async batch
+		FCollisionQueryParams Params(SCENE_QUERY_STAT(VrmSpringBone), false, ignoreActor);
+		for (auto &s : spring) {
+			for (const auto &req : s.physicsRequest) {
+				const FVector End = req.start + FVector(0.001f);
+				q.handle.Add(world->AsyncSweepByObjectType(EAsyncTraceType::Multi, req.start, End,
+					FCollisionObjectQueryParams(req.objectMask), FCollisionShape::MakeSphere(req.radius), Params));
+				q.pending.Add(req);
+			}
+			s.physicsRequest.Reset();
+		}
+	}
 
-						auto &sData = chain.AddDefaulted_GetRef();
+	void VRMSpringManager::capture(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output) {
+		param.DeltaTime = DeltaTime;
+		param.ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
+		param.WorldContext = Output.AnimInstanceProxy->GetSkelMeshComponent();
+		param.loopc = animNode->loopc;
+		param.gravityScale = animNode->gravityScale;
+		param.gravityAdd = animNode->gravityAdd;
+		param.stiffnessScale = animNode->stiffnessScale;
+		param.stiffnessAdd = animNode->stiffnessAdd;
+		param.bIgnorePhysicsCollision = animNode->bIgnorePhysicsCollision;
+		param.bAsyncPhysicsCollision = animNode->bAsyncPhysicsCollision;
+		param.bIgnoreVRMCollision = animNode->bIgnoreVRMCollision;
+
+		param.bSkip = animNode->bLODSkipSolve;
+		param.maxDepth = 0;
+		if (const auto *lod = animNode->GetLODSetting()) {
+			param.maxDepth = lod->MaxChainDepth;
+			if (lod->bSkipCollision) {
+				param.bIgnorePhysicsCollision = true;
+				param.bIgnoreVRMCollision = true;
+			}
+		}
 
-						sData.boneIndex = Children[0];
-						sData.boneName = *RefSkeleton.GetBoneName(sData.boneIndex).ToString();
+		param.sleepFrame = animNode->bChainSleep ? FMath::Max(1, animNode->SleepFrameCount) : 0;
+		param.sleepVelocity = animNode->SleepVelocity;
+		param.sleepRootRotation = animNode->SleepRootRotation;
+
+		param.bFixedTimestep = animNode->bFixedTimestep && animNode->FixedTimestepRate > 0.f;
+		param.fixedStepNum = 0;
+		param.interpAlpha = 1.f;
+		if (param.bFixedTimestep) {
+			const float step = 1.f / animNode->FixedTimestepRate;
+			const int maxStep = FMath::Max(1, animNode->MaxSubstep);
+
+			// a skipped frame carries its time to the next solve (LODSkippedTime). not accumulated here
+			if (param.bSkip == false) {
+				timeAccumulator += DeltaTime;
+				param.fixedStepNum = FMath::Min(FMath::FloorToInt(timeAccumulator / step), maxStep);
+				timeAccumulator -= param.fixedStepNum * step;
+				// hitch. drop the time over the budget
+				timeAccumulator = FMath::Min(timeAccumulator, step);
+			}
 
-						GetDirectChildBonesLocal(skeletalMesh->RefSkeleton, sData.boneIndex, Children);
-						if (Children.Num() > 0) {
-							sData.m_boneAxis = RefSkeletonTransform[Children[0]].GetLocation();
-						}
-						else {
-							sData.m_boneAxis = RefSkeletonTransform[sData.boneIndex].GetLocation() * 0.7f;
-						}
-					}
+			param.fixedStepDelta = step;
+			param.interpAlpha = FMath::Clamp(timeAccumulator / step, 0.f, 1.f);
+		} else {
+			timeAccumulator = 0.f;
+		}
+
+		for (auto &s : spring) {
+			for (const auto &c : s.setting->chain) {
+				const int32 j = c.start;
+				joint.m_active[j] = (joint.compactIndex[j] != INDEX_NONE);
+				if (joint.m_active[j]) {
+					joint.m_rootPose[j] = Output.Pose.GetComponentSpaceTransform(joint.compactIndex[j]);
 				}
 			}
-	
-			
-			s.ColliderGroupIndexArray.SetNum(metaS.ColliderIndexArray.Num());
-			for (int c = 0; c < s.ColliderGroupIndexArray.Num(); ++c) {
-				s.ColliderGroupIndexArray[c] = metaS.ColliderIndexArray[c];
-			}
+		}
 
+		if (param.bIgnoreVRMCollision == false) {
+			updateCollider(Output);
 		}
 
-		// init default transform
-		const FTransform center = Output.AnimInstanceProxy->GetComponentTransform();
 		for (auto &s : spring) {
-			for (auto &root : s.SpringDataChain) {
-				for (auto &sData : root) {
-					sData.m_length = sData.m_boneAxis.Size();
+			s.physicsObjectMask = animNode->PhysicsCollisionChannelMask;
+		}
+		if (animNode->VrmMetaObject) {
+			const auto &metaS = animNode->VrmMetaObject->VRMSpringMeta;
+			for (int i = 0; i < spring.Num() && i < metaS.Num(); ++i) {
+				if (metaS[i].physicsCollisionChannelMask >= 0) {
+					spring[i].physicsObjectMask = metaS[i].physicsCollisionChannelMask;
+				}
+			}
+		}
+	}
+
+	void VRMSpringManager::solveSpring(int32 i) {
+		const uint32 start = FPlatformTime::Cycles();
+		spring[i].Update(*tmpl, param, collider, joint, physicsQuery);
+		FPlatformAtomics::InterlockedAdd(&solveCycles, (int32)(FPlatformTime::Cycles() - start));
+	}
+
+	void VRMSpringManager::warmStart(FComponentSpacePoseContext& Output) {
+		// restart from the current pose without velocity
+		const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
+		const auto &js = tmpl->joint;
+		for (int j = 0; j < joint.Num(); ++j) {
+			const int32 parent = js.parentJoint[j];
+			if (parent == INDEX_NONE) {
+				joint.m_active[j] = (joint.compactIndex[j] != INDEX_NONE);
+				if (joint.m_active[j] == 0) {
+					continue;
+				}
+				joint.m_transform[j] = Output.Pose.GetComponentSpaceTransform(joint.compactIndex[j]);
+			} else {
+				joint.m_active[j] = joint.m_active[parent];
+				joint.m_transform[j] = js.refLocal[j] * joint.m_transform[parent];
+			}
+			const FVector tail = ComponentTransform.TransformPosition(joint.m_transform[j].TransformPosition(js.m_boneAxis[j]));
+			joint.m_currentTail[j] = joint.m_prevTail[j] = tail;
+			joint.m_resultQuat[j] = joint.m_prevResultQuat[j] = joint.m_outputQuat[j] = joint.m_transform[j].GetRotation();
+		}
+		for (auto &s : spring) {
+			s.InitSleep();
+		}
+		timeAccumulator = 0.f;
+	}
 
-					
-					//FCompactPoseBoneIndex uu(RefSkeleton.GetParentIndex(sData.boneIndex));
-					//FTransform t = Output.Pose.GetComponentSpaceTransform(uu);
-					//sData.m_transform = RefSkeletonTransform[(sData.boneIndex)] * t * center;
-					//t = RefSkeletonTransform[(sData.boneIndex)] * t;
+	void VRMSpringManager::update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms) {
+		capture(animNode, DeltaTime, Output);
+
+		for (int i = 0; i < spring.Num(); ++i) {
+			solveSpring(i);
+		}
+		bSolved = true;
+	}
 
-					FCompactPoseBoneIndex uu(sData.boneIndex);
-					sData.m_transform = Output.Pose.GetComponentSpaceTransform(uu) * center;
-					FTransform t = Output.Pose.GetComponentSpaceTransform(uu);
+	void VRMSpringManager::updateOutput() {
+		for (const auto &s : spring) {
+			s.UpdateOutput(*tmpl, joint);
+		}
+	}
 
-					sData.m_currentTail = sData.m_prevTail = t.TransformPosition(sData.m_boneAxis);
+	void VRMSpringManager::output(int32 boneNum, TArray<FBoneTransform>& OutBoneTransforms) {
+		// first joint wins for a bone shared by chains
+		outputBit.Init(false, boneNum);
+		outputBuffer.SetNumUninitialized(boneNum, false);
+
+		int32 num = 0;
+		const int maxDepth = param.maxDepth;
+		for (const auto &s : spring) {
+			for (const auto &c : s.setting->chain) {
+				const int depthNum = (maxDepth > 0) ? FMath::Min(c.num, maxDepth) : c.num;
+				for (int j = c.start; j < c.start + depthNum; ++j) {
+					const int32 bone = joint.compactIndex[j].GetInt();
+					if (bone == INDEX_NONE || bone >= boneNum) {
+						break;
+					}
+					if (outputBit[bone]) {
+						continue;
+					}
+					outputBit[bone] = true;
+					outputBuffer[bone] = joint.m_outputTransform[j];
+					++num;
 				}
 			}
 		}
 
-		// collider
-		colliderGroup.SetNum(meta->VRMColliderMeta.Num());
-		for (int i=0; i<colliderGroup.Num(); ++i){
-			auto &cg = colliderGroup[i];
-			const auto &cmeta = meta->VRMColliderMeta[i];
+		OutBoneTransforms.Reserve(num);
+		for (TConstSetBitIterator<> it(outputBit); it; ++it) {
+			const int32 bone = it.GetIndex();
+			OutBoneTransforms.Add(FBoneTransform(FCompactPoseBoneIndex(bone), outputBuffer[bone]));
+		}
+	}
 
-			cg.node = cmeta.bone;
-			cg.node_name = *cmeta.boneName;
+	bool IsScheduled(const VRMSpringManager &manager) {
+		return manager.bScheduled;
+	}
 
-			cg.colliders.SetNum(cmeta.collider.Num());
-			for (int c = 0; c < cg.colliders.Num(); ++c) {
-				cg.colliders[c].offset = cmeta.collider[c].offset;
-				cg.colliders[c].radius = cmeta.collider[c].radius;
+	void SolveScheduled(const TArray<TSharedPtr<VRMSpringManager, ESPMode::ThreadSafe>> &managerList) {
+		struct FWork {
+			VRMSpringManager *manager;
+			int32 spring;
+		};
+		TArray<FWork> work;
+		for (const auto &m : managerList) {
+			if (m.IsValid() == false || m->bInit == false || m->bScheduled == false) {
+				continue;
+			}
+			for (int i = 0; i < m->spring.Num(); ++i) {
+				work.Add({ m.Get(), i });
 			}
+		}
 
-			TArray<VRMSpringCollider> colliders;
+		for (const auto &m : managerList) {
+			if (m.IsValid()) {
+				m->SolveLock.Lock();
+			}
 		}
 
+		// springs of one manager write disjoint joints
+		ParallelFor(work.Num(), [&work](int32 i) {
+			work[i].manager->solveSpring(work[i].spring);
+		});
 
-		bInit = true;
-	}
-	void VRMSpringManager::update(const FAnimNode_VrmSpringBone *animNode, float DeltaTime, FComponentSpacePoseContext& Output, TArray<FBoneTransform>& OutBoneTransforms) {
-		for (int i = 0; i < spring.Num(); ++i) {
-			FTransform c;
-			//c = Output.AnimInstanceProxy->GetComponentTransform();
-			c = Output.AnimInstanceProxy->GetActorTransform();
-			
-			spring[i].Update(animNode, DeltaTime, c, colliderGroup, Output);
+		for (const auto &m : managerList) {
+			if (m.IsValid()) {
+				if (m->bInit && m->bScheduled) {
+					m->bSolved = true;
+				}
+				m->SolveLock.Unlock();
+			}
 		}
 	}
 }
@@ -477,6 +1256,10 @@ void FAnimNode_VrmSpringBone::Initialize_AnyThread(const FAnimationInitializeCon
 }
 void FAnimNode_VrmSpringBone::CacheBones_AnyThread(const FAnimationCacheBonesContext& Context) {
 	Super::CacheBones_AnyThread(Context);
+	if (SpringManager.Get() && SpringManager->bInit) {
+		// required bones changed (LOD etc.)
+		SpringManager->resolveCompactIndex(Context.AnimInstanceProxy->GetRequiredBones());
+	}
 }
 
 #if	UE_VERSION_OLDER_THAN(4,20,0)
@@ -497,6 +1280,80 @@ void FAnimNode_VrmSpringBone::ResetDynamics(ETeleportType InTeleportType) {
 }
 #endif
 
+void FAnimNode_VrmSpringBone::PreUpdate(const UAnimInstance* InAnimInstance) {
+	if (SpringManager.Get() == nullptr || InAnimInstance == nullptr) {
+		return;
+	}
+	const USkeletalMeshComponent *comp = InAnimInstance->GetSkelMeshComponent();
+	if (comp == nullptr) {
+		return;
+	}
+
+	// LOD input
+	{
+		bLODVisible = comp->bRecentlyRendered;
+		LODScreenSize = 1.f;
+
+		const APlayerCameraManager *camera = UGameplayStatics::GetPlayerCameraManager(comp, 0);
+		if (camera) {
+			const float dist = FMath::Max(1.f, FVector::Dist(camera->GetCameraLocation(), comp->Bounds.Origin));
+			const float halfFov = FMath::DegreesToRadians(FMath::Max(1.f, camera->GetFOVAngle()) * 0.5f);
+			LODScreenSize = comp->Bounds.SphereRadius / (dist * FMath::Tan(halfFov));
+		}
+	}
+
+	if (bIgnorePhysicsCollision || bAsyncPhysicsCollision == false) {
+		SpringManager->physicsQuery.Reset();
+		return;
+	}
+	SpringManager->updatePhysicsQuery(comp->GetWorld(), comp->GetOwner());
+}
+
+const FVrmSpringBoneLODSetting *FAnimNode_VrmSpringBone::GetLODSetting() const {
+	if (LODSetting.IsValidIndex(LODIndex)) {
+		return &LODSetting[LODIndex];
+	}
+	return nullptr;
+}
+
+void FAnimNode_VrmSpringBone::UpdateLOD() {
+	// screen size
+	int lod = INDEX_NONE;
+	for (int i = 0; i < LODSetting.Num(); ++i) {
+		if (LODScreenSize <= LODSetting[i].ScreenSize) {
+			lod = i;
+		}
+	}
+
+	// budget
+	if (SpringManager.Get()) {
+		const int32 cycles = FPlatformAtomics::InterlockedExchange(&SpringManager->solveCycles, 0);
+		if (cycles > 0) {
+			const auto *cur = GetLODSetting();
+			const float divisor = cur ? (float)FMath::Max(1, cur->UpdateRateDivisor) : 1.f;
+			const float us = FPlatformTime::ToMilliseconds(cycles) * 1000.f / divisor;
+			LODCostMicroSeconds = FMath::Lerp(LODCostMicroSeconds, us, 0.1f);
+		}
+	}
+	if (BudgetMicroSeconds > 0.f && LODSetting.Num() > 0) {
+		if (LODBudgetCooldown > 0) {
+			--LODBudgetCooldown;
+		} else if (LODCostMicroSeconds > BudgetMicroSeconds && LODBudgetBias < LODSetting.Num()) {
+			++LODBudgetBias;
+			LODBudgetCooldown = 30;
+		} else if (LODCostMicroSeconds < BudgetMicroSeconds * 0.5f && LODBudgetBias > 0) {
+			--LODBudgetBias;
+			LODBudgetCooldown = 30;
+		}
+	} else {
+		LODBudgetBias = 0;
+	}
+	if (LODBudgetBias > 0) {
+		lod = FMath::Max(lod, LODBudgetBias - 1);
+	}
+	LODIndex = FMath::Min(lod, LODSetting.Num() - 1);
+}
+
 void FAnimNode_VrmSpringBone::UpdateInternal(const FAnimationUpdateContext& Context){
 	Super::UpdateInternal(Context);
 
@@ -543,7 +1400,6 @@ void FAnimNode_VrmSpringBone::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 {
 	check(OutBoneTransforms.Num() == 0);
 
-	const auto RefSkeleton = Output.AnimInstanceProxy->GetSkeleton()->GetReferenceSkeleton();
 	const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
 
 	//dstRefSkeleton.GetParentIndex
@@ -563,73 +1419,69 @@ void FAnimNode_VrmSpringBone::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 			return;
 		}
 
-		const auto &RefSkeletonTransform = RefSkeleton.GetRefBonePose();
-
 		{
 			if (SpringManager.Get() == nullptr) {
 				return;
 			}
+			FScopeLock lock(&SpringManager->SolveLock);
+
+			if (SpringManager->bInit && SpringManager->tmplVersion != VrmMetaObject->SpringBakeVersion) {
+				// springs or colliders were rebaked
+				SpringManager->reset();
+			}
 			if (SpringManager->bInit == false) {
 				SpringManager->init(VrmMetaObject, Output);
-				return;
+				if (SpringManager->bInit == false) {
+					return;
+				}
 			}
 
-			SpringManager->update(this, CurrentDeltaTime, Output, OutBoneTransforms);
-
-			for (auto &springRoot : SpringManager->spring) {
-				for (auto &sChain : springRoot.SpringDataChain) {
-					int BoneChain = 0;
-
-					FTransform CurrentTransForm = FTransform::Identity;
-					for (auto &sData : sChain) {
-
-
-						FCompactPoseBoneIndex CompactPoseBoneToModify(sData.boneIndex);
-
-
-						FTransform NewBoneTM;
-
-						NewBoneTM = Output.Pose.GetComponentSpaceTransform(CompactPoseBoneToModify);
-						NewBoneTM.SetRotation(sData.m_resultQuat);
-						if (BoneChain == 0) {
-							NewBoneTM = Output.Pose.GetComponentSpaceTransform(CompactPoseBoneToModify);
-							NewBoneTM.SetRotation(sData.m_resultQuat);
-
-							CurrentTransForm = NewBoneTM;
-						}else{
-
-							NewBoneTM = CurrentTransForm;
-							
-							auto c = RefSkeletonTransform[sData.boneIndex];
-							NewBoneTM = c * NewBoneTM;
-							NewBoneTM.SetRotation(sData.m_resultQuat);
-
-
-							//const FTransform ComponentTransform = Output.AnimInstanceProxy->GetComponentTransform();
-							//NewBoneTM.SetLocation(ComponentTransform.TransformPosition(sData.m_currentTail));
-
-							CurrentTransForm = NewBoneTM;
-						}
+			UpdateLOD();
+			if (bFreezeOffscreen && bLODVisible == false) {
+				bLODFrozen = true;
+				return;
+			}
+			if (bLODFrozen) {
+				bLODFrozen = false;
+				SpringManager->warmStart(Output);
+			}
 
-						FBoneTransform a(CompactPoseBoneToModify, NewBoneTM);
+			// update rate. skipped frames are added to the next step
+			const float DeltaTime = CurrentDeltaTime + LODSkippedTime;
+			{
+				const auto *lod = GetLODSetting();
+				const int divisor = lod ? FMath::Max(1, lod->UpdateRateDivisor) : 1;
+				bLODSkipSolve = ((++LODFrameCount) % divisor) != 0;
+				LODSkippedTime = bLODSkipSolve ? DeltaTime : 0.f;
+			}
 
-						bool bFirst = true;
-						for (auto &t : OutBoneTransforms) {
-							if (t.BoneIndex == a.BoneIndex) {
-								bFirst = false;
-								break;
-							}
-						}
+			FVrmSpringBoneScheduler *scheduler = nullptr;
+			if (GetDefault<UVrmRuntimeSettings>()->bSpringBoneScheduler) {
+				const auto *comp = Output.AnimInstanceProxy->GetSkelMeshComponent();
+				scheduler = FVrmSpringBoneScheduler::Get(comp ? comp->GetWorld() : nullptr);
+			}
 
-						if (bFirst) {
-							OutBoneTransforms.Add(a);
-						}
-						BoneChain++;
-					}
+			if (scheduler) {
+				// solved after the world tick. use the last result
+				SpringManager->capture(this, DeltaTime, Output);
+				if (SpringManager->bScheduled == false || SpringManager->schedulerSerial != scheduler->GetSerial()) {
+					SpringManager->bScheduled = true;
+					SpringManager->schedulerSerial = scheduler->GetSerial();
+					scheduler->Register(SpringManager);
 				}
+				if (SpringManager->bSolved == false) {
+					return;
+				}
+			} else {
+				SpringManager->bScheduled = false;
+				SpringManager->update(this, DeltaTime, Output, OutBoneTransforms);
+			}
 
+			if (scheduler || bLODSkipSolve) {
+				// the last solve used an older root pose
+				SpringManager->updateOutput();
 			}
-			OutBoneTransforms.Sort(FCompareBoneTransformIndex());
+			SpringManager->output(Output.Pose.GetPose().GetNumBones(), OutBoneTransforms);
 
 		}
 		/*
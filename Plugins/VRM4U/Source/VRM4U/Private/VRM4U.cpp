@@ -4,6 +4,7 @@
 #include "VRM4U.h"
 #include "Modules/ModuleManager.h"
 #include "VrmRuntimeSettings.h"
+#include "VrmSpringBoneScheduler.h"
 #include "Developer/Settings/Public/ISettingsModule.h"
 
 //#include "ISettingsModule.h"
@@ -18,6 +19,8 @@ void FVRM4UModule::StartupModule()
 	{
 	
 	}
+	FVrmSpringBoneScheduler::StartupModule();
+
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
 		SettingsModule->RegisterSettings("Project", "Plugins", "VRM4U",
@@ -32,6 +35,7 @@ void FVRM4UModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	FVrmSpringBoneScheduler::ShutdownModule();
 
 	if (ISettingsModule* SettingsModule = FModuleManager::GetModulePtr<ISettingsModule>("Settings"))
 	{
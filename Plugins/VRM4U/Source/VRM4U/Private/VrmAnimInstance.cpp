@@ -22,233 +22,108 @@ bool FVrmAnimInstanceProxy::Evaluate(FPoseContext& Output) {
 		return false;
 	}
 
-	/*
-	enum BoneTarget{
-		E_Hand_L,
-		E_UpperArm_L,
-		E_Hand_R,
-		E_UpperArm_R,
-		E_Head,
-		E_Spine,
-
-		E_MAX,
-	};
-
-	// boneName
-	FString targetBoneTable[] = {
-		TEXT("leftHand"),
-		TEXT("leftUpperArm"),
-		TEXT("rightHand"),
-		TEXT("rightUpperArm"),
-		TEXT("head"),
-		TEXT("spine"),
-	};
-	{
-		const UVrmMetaObject *meta = animInstance->MetaObject;
-		if (meta) {
-			for (auto &humanoidName : targetBoneTable) {
-				for (auto &modelName : meta->humanoidBoneTable) {
-					if (humanoidName.Compare(modelName.Key, ESearchCase::IgnoreCase) != 0) {
-						continue;
-					}
-					// bone rename
-					humanoidName = modelName.Value;
-					break;
-				}
-			}
+	// expression stream
+	bStreamMorphWeight = false;
+	if (ExpressionTable.meta) {
+		float groupWeight[(int)EVrmMorphGroupType::Num];
+		const double time = FPlatformTime::Seconds() - ExpressionStreamDelay;
+		double sampleTime = 0;
+		if (animInstance->ExpressionStream.Sample(time, groupWeight, &sampleTime) && sampleTime != StreamSampleTime) {
+			ExpressionTable.Evaluate(groupWeight, StreamMorphWeight);
+			StreamSampleTime = sampleTime;
+			bStreamMorphWeight = true;
 		}
 	}
 
-	// tracking point
-	FTransform targetTracking[] = {
-		animInstance->TransHandLeft,
-		animInstance->TransHandRight,
-		animInstance->TransHead,
-	};
-	{
-		const USceneComponent *targetComponent[] = {
-			animInstance->ComponentHandLeft,
-			animInstance->ComponentHandRight,
-			animInstance->ComponentHead,
-		};
-
-		for (int i = 0; i < 3; ++i) {
-			if (targetComponent[i] == nullptr) continue;
-			targetTracking[i] = targetComponent[i]->GetComponentTransform();
-		}
+	// tracking. skipped until a target is set
+	bool bTracking = false;
+	for (const auto &t : TrackingTarget) {
+		bTracking |= (t.GetLocation().Size() != 0);
 	}
-
-	// mainBone Transform
-	//FTeransform boneTransform[E_MAX] = {
-
-	//};
-
-
-
-	USkeletalMeshComponent *srcMesh = animInstance->BaseSkeletalMeshComponent;
-	if (srcMesh == nullptr) {
-	//	return false;
+	const USkeletalMesh *mesh = GetSkelMeshComponent()->SkeletalMesh;
+	if (bTracking == false || TrackingMeta == nullptr || mesh == nullptr) {
+		return true;
 	}
 
-	const auto &RefSkeletonTransform = GetSkelMeshComponent()->SkeletalMesh->RefSkeleton.GetRefBonePose();
+	if (IKMeta != TrackingMeta || IKMesh != mesh) {
+		BuildIK(TrackingMeta, mesh);
+	}
 
-	auto &pose = Output.Pose;
+	// bone references follow the required bones. a LOD switch can keep the count and change the bones
+	FAnimationCacheBonesContext CacheBonesContext(this);
+	const auto &RequiredBones = Output.Pose.GetBoneContainer();
+	if (IKCompactBoneIndices != RequiredBones.GetBoneIndicesArray()) {
+		IKCompactBoneIndices = RequiredBones.GetBoneIndicesArray();
+		HandIK[0]->CacheBones_AnyThread(CacheBonesContext);
+		HandIK[1]->CacheBones_AnyThread(CacheBonesContext);
+		HeadIK->CacheBones_AnyThread(CacheBonesContext);
+	}
 
 	FComponentSpacePoseContext ComponentSpacePoseContext(Output.AnimInstanceProxy);
 	ComponentSpacePoseContext.Pose.InitPose(Output.Pose);
 
-	for (int i = 2; i >=0 ; --i) {
-
-		if (targetTracking[i].GetLocation().Size() == 0) {
-			continue;
-		}
-
-		FAnimNode_Fabrik f;
-		{
-
-			f.EffectorTransformSpace = EBoneControlSpace::BCS_WorldSpace;
-			f.EffectorTransform = targetTracking[i];
-
-			//f.EffectorTarget;
-
-			f.EffectorRotationSource = EBoneRotationSource::BRS_CopyFromTarget;
-
-			f.TipBone.BoneName = *(targetBoneTable[i * 2]);
-			f.TipBone.Initialize(this->GetSkeleton());
-
-			f.RootBone.BoneName = *(targetBoneTable[i * 2 + 1]);
-			f.RootBone.Initialize(this->GetSkeleton());
+	USkeleton* LocalSkeleton = ComponentSpacePoseContext.AnimInstanceProxy->GetSkeleton();
+	if (LocalSkeleton == nullptr) {
+		return true;
+	}
 
-			f.Precision = 1.f;
-			f.MaxIterations = 10;
-			f.bEnableDebugDraw = false;
+	TArray<FBoneTransform> BoneTransforms;
+	TArray<FCompactPoseBoneIndex> modifiedBones;
+	auto evaluateIK = [&](FAnimNode_SkeletalControlBase &SingleBoneController) {
+		if (SingleBoneController.IsValidToEvaluate(LocalSkeleton, RequiredBones) == false) {
+			return;
 		}
-		FAnimNode_TwoBoneIK t;
-		{
-			t.IKBone.BoneName = *(targetBoneTable[i * 2]);
-
-			t.bAllowStretching = true;
-			t.StartStretchRatio = 1.f;
-			t.MaxStretchScale = 1.1f;
-			//t.bTakeRotationFromEffectorSpace = false;
-			t.bMaintainEffectorRelRot = false;
-			t.bAllowTwist = true;
-
-			t.EffectorLocationSpace = EBoneControlSpace::BCS_WorldSpace;
-
-			t.EffectorLocation = targetTracking[i].GetLocation();
-
-			//f.EffectorTarget;
-
-			t.JointTargetLocationSpace = EBoneControlSpace::BCS_WorldSpace;
-
-			const USceneComponent *tmp[] = {
-				animInstance->ComponentHandJointTargetLeft,
-				animInstance->ComponentHandJointTargetRight,
-				nullptr,
-			};
-			if (tmp[i]) {
-				t.JointTargetLocation = tmp[i]->GetComponentLocation();
+		BoneTransforms.Reset();
+		SingleBoneController.EvaluateSkeletalControl_AnyThread(ComponentSpacePoseContext, BoneTransforms);
+		if (BoneTransforms.Num() > 0) {
+			ComponentSpacePoseContext.Pose.LocalBlendCSBoneTransforms(BoneTransforms, 1.0f);
+			for (const auto &b : BoneTransforms) {
+				modifiedBones.AddUnique(b.BoneIndex);
 			}
-			//f.JointTarget;
 		}
-		FAnimNode_SplineIK s;
-		{
-			s.StartBone.BoneName = *targetBoneTable[E_Spine];
-			s.StartBone.Initialize(this->GetSkeleton());
-			s.EndBone.BoneName = *targetBoneTable[E_Head];
-			s.EndBone.Initialize(this->GetSkeleton());
-
-			s.BoneAxis = ESplineBoneAxis::Y;
-
-			s.bAutoCalculateSpline = false;
-
-			s.PointCount = 2;
-
-			s.ControlPoints.SetNum(2);
-			s.ControlPoints[0].SetIdentity();
-			s.ControlPoints[1] = targetTracking[2];
-			s.ControlPoints[1].SetToRelativeTransform(GetComponentTransform());
-
-			//ComponentSpacePoseContext.
-
-			s.Roll = 0.f;
-
-			s.TwistStart = 0.f;
-
-			s.TwistEnd = 0.f;
-
-			//s.TwistBlend;
-
-			s.Stretch = 0.01f;
+	};
 
-			s.Offset = 0.f;
+	// head first. spine to head
+	if (TrackingTarget[2].GetLocation().Size() != 0) {
+		auto &s = *HeadIK.Get();
+		s.ControlPoints[1] = TrackingTarget[2];
+		s.ControlPoints[1].SetToRelativeTransform(GetComponentTransform());
+		evaluateIK(s);
+	}
+	for (int i = 1; i >= 0; --i) {
+		if (TrackingTarget[i].GetLocation().Size() == 0) {
+			continue;
 		}
+		auto &t = *HandIK[i].Get();
+		t.EffectorLocation = TrackingTarget[i].GetLocation();
+		t.JointTargetLocation = TrackingJointTarget[i];
+		evaluateIK(t);
+	}
 
-		{
-
-			//ApplyBoneControllers(GetCurveBoneControllers(), ComponentSpacePoseContext);
-			//ApplyBoneControllers(BoneControllers, ComponentSpacePoseContext);
-			if (USkeleton* LocalSkeleton = ComponentSpacePoseContext.AnimInstanceProxy->GetSkeleton())
-			{
-				//for (auto& SingleBoneController : InBoneControllers)
-				if (i != 2) {
-					auto &SingleBoneController = t;
-
-					TArray<FBoneTransform> BoneTransforms;
-					FAnimationCacheBonesContext Proxy(this);
-					SingleBoneController.CacheBones_AnyThread(Proxy);
-					if (SingleBoneController.IsValidToEvaluate(LocalSkeleton, ComponentSpacePoseContext.Pose.GetPose().GetBoneContainer()))
-					{
-						SingleBoneController.EvaluateSkeletalControl_AnyThread(ComponentSpacePoseContext, BoneTransforms);
-						if (BoneTransforms.Num() > 0)
-						{
-							ComponentSpacePoseContext.Pose.LocalBlendCSBoneTransforms(BoneTransforms, 1.0f);
-						}
-					}
-				} else {
-					auto &SingleBoneController = s;
-
-					TArray<FBoneTransform> BoneTransforms;
-					FAnimationCacheBonesContext Proxy(this);
-					SingleBoneController.CacheBones_AnyThread(Proxy);
-					if (SingleBoneController.IsValidToEvaluate(LocalSkeleton, ComponentSpacePoseContext.Pose.GetPose().GetBoneContainer()))
-					{
-						SingleBoneController.EvaluateSkeletalControl_AnyThread(ComponentSpacePoseContext, BoneTransforms);
-						if (BoneTransforms.Num() > 0)
-						{
-							ComponentSpacePoseContext.Pose.LocalBlendCSBoneTransforms(BoneTransforms, 1.0f);
-						}
-					}
-				}
-			}
+	// back to local. only the bones the IK modified
+	for (const auto &bi : modifiedBones) {
+		FTransform t = ComponentSpacePoseContext.Pose.GetComponentSpaceTransform(bi);
+		const FCompactPoseBoneIndex parent = Output.Pose.GetParentBoneIndex(bi);
+		if (parent != INDEX_NONE) {
+			t.SetToRelativeTransform(ComponentSpacePoseContext.Pose.GetComponentSpaceTransform(parent));
 		}
+		t.NormalizeRotation();
+		Output.Pose[bi] = t;
 	}
-	//
-#if	UE_VERSION_OLDER_THAN(4,21,0)
-	ComponentSpacePoseContext.Pose.ConvertToLocalPoses(Output.Pose);
-#endif
 
-	for (int i=0; i<3; ++i){
-		auto b = GetSkelMeshComponent()->GetBoneIndex(*targetBoneTable[i*2]);
-		if (b == INDEX_NONE) {
+	// hand rotation from the tracker
+	for (int i = 0; i < 2; ++i) {
+		if (TrackingTarget[i].GetLocation().Size() == 0) {
+			continue;
+		}
+		const FCompactPoseBoneIndex bi = HandIK[i]->IKBone.GetCompactPoseIndex(RequiredBones);
+		if (bi == INDEX_NONE) {
 			continue;
 		}
-		FCompactPose::BoneIndexType bi(b);
 		auto t = Output.Pose[bi];
-		auto tmp = targetTracking[i];
-		//tmp.SetToRelativeTransform(GetComponentTransform());
-		//t.SetRotation( GetComponentTransform().GetRotation().Inverse() * (tmp.GetRotation()) );
-
-		
-		//const FTransform& BoneTM = ComponentSpacePoseContext.Pose.GetComponentSpaceTransform(bi);
-		t.SetRotation( t.GetRotation() * (tmp.GetRotation()) );
+		t.SetRotation(t.GetRotation() * TrackingTarget[i].GetRotation());
 		Output.Pose[bi] = t;
 	}
-	*/
-
-
-
 
 /*
 	for (auto &boneName : meta->humanoidBoneTable) {
@@ -290,6 +165,59 @@ void FVrmAnimInstanceProxy::UpdateAnimationNode(const FAnimationUpdateContext& I
 }
 #endif
 
+void FVrmAnimInstanceProxy::BuildIK(const UVrmMetaObject *meta, const USkeletalMesh *mesh) {
+	IKMeta = meta;
+	IKMesh = mesh;
+	IKCompactBoneIndices.Reset();
+
+	// humanoid name to model bone name
+	auto boneName = [meta](const TCHAR *humanoidName) {
+		const auto *name = meta->humanoidBoneTable.Find(humanoidName);
+		return name ? FName(**name) : FName(humanoidName);
+	};
+
+	const TCHAR *handTable[] = {
+		TEXT("leftHand"),
+		TEXT("rightHand"),
+	};
+	for (int i = 0; i < 2; ++i) {
+		HandIK[i] = MakeShareable(new FAnimNode_TwoBoneIK());
+		auto &t = *HandIK[i].Get();
+
+		t.IKBone.BoneName = boneName(handTable[i]);
+
+		t.bAllowStretching = true;
+		t.StartStretchRatio = 1.f;
+		t.MaxStretchScale = 1.1f;
+		t.bMaintainEffectorRelRot = false;
+		t.bAllowTwist = true;
+
+		t.EffectorLocationSpace = EBoneControlSpace::BCS_WorldSpace;
+		t.JointTargetLocationSpace = EBoneControlSpace::BCS_WorldSpace;
+	}
+
+	{
+		HeadIK = MakeShareable(new FAnimNode_SplineIK());
+		auto &s = *HeadIK.Get();
+
+		s.StartBone.BoneName = boneName(TEXT("spine"));
+		s.EndBone.BoneName = boneName(TEXT("head"));
+
+		s.BoneAxis = ESplineBoneAxis::Y;
+		s.bAutoCalculateSpline = false;
+		s.PointCount = 2;
+		s.ControlPoints.SetNum(2);
+		s.ControlPoints[0].SetIdentity();
+		s.ControlPoints[1].SetIdentity();
+
+		s.Roll = 0.f;
+		s.TwistStart = 0.f;
+		s.TwistEnd = 0.f;
+		s.Stretch = 0.01f;
+		s.Offset = 0.f;
+	}
+}
+
 /////
 
 UVrmAnimInstance::UVrmAnimInstance(const FObjectInitializer& ObjectInitializer)
@@ -298,8 +226,8 @@ UVrmAnimInstance::UVrmAnimInstance(const FObjectInitializer& ObjectInitializer)
 }
 
 FAnimInstanceProxy* UVrmAnimInstance::CreateAnimInstanceProxy() {
-
-	return new FVrmAnimInstanceProxy(this);
+	myProxy = new FVrmAnimInstanceProxy(this);
+	return myProxy;
 }
 
 
@@ -307,6 +235,42 @@ void UVrmAnimInstance::NativeInitializeAnimation() {
 }
 void UVrmAnimInstance::NativeUpdateAnimation(float DeltaSeconds) {
 
+	UpdateExpressionTable();
+
+	// tracking. scene components are read here, not on the worker thread
+	if (myProxy) {
+		// the worker thread samples the expression stream with its own copy
+		if (myProxy->ExpressionTable.meta != ExpressionTable.meta) {
+			myProxy->ExpressionTable = ExpressionTable;
+			myProxy->StreamSampleTime = -1.0;
+		}
+		myProxy->ExpressionStreamDelay = ExpressionStreamDelay;
+
+		myProxy->TrackingMeta = MetaObject;
+
+		const FTransform trans[] = {
+			TransHandLeft,
+			TransHandRight,
+			TransHead,
+		};
+		const USceneComponent *targetComponent[] = {
+			ComponentHandLeft,
+			ComponentHandRight,
+			ComponentHead,
+		};
+		for (int i = 0; i < 3; ++i) {
+			myProxy->TrackingTarget[i] = targetComponent[i] ? targetComponent[i]->GetComponentTransform() : trans[i];
+		}
+
+		const USceneComponent *jointTarget[] = {
+			ComponentHandJointTargetLeft,
+			ComponentHandJointTargetRight,
+		};
+		for (int i = 0; i < 2; ++i) {
+			myProxy->TrackingJointTarget[i] = jointTarget[i] ? jointTarget[i]->GetComponentLocation() : FVector::ZeroVector;
+		}
+	}
+
 	{
 		if (BaseSkeletalMeshComponent == nullptr) {
 			return;
@@ -340,6 +304,16 @@ void UVrmAnimInstance::NativeUpdateAnimation(float DeltaSeconds) {
 	//}
 }
 void UVrmAnimInstance::NativePostEvaluateAnimation() {
+	if (myProxy && myProxy->bStreamMorphWeight) {
+		const auto &table = myProxy->ExpressionTable;
+		if (myProxy->StreamMorphWeight.Num() == table.morphName.Num()) {
+			for (int i = 0; i < table.morphName.Num(); ++i) {
+				SetMorphTarget(table.morphName[i], myProxy->StreamMorphWeight[i]);
+			}
+		}
+		myProxy->bStreamMorphWeight = false;
+	}
+
 	auto targetComponent = Cast<USkeletalMeshComponent>(this);
 	if (targetComponent) {
 		//for (auto &a : targetComponent->BoneSpaceTransforms) {
@@ -374,45 +348,162 @@ namespace {
 }
 
 
-void UVrmAnimInstance::SetMorphTargetVRM(EVrmMorphGroupType type, float Value) {
-
-	if (MetaObject == nullptr){
+void FVrmExpressionTable::Build(const UVrmMetaObject *InMeta) {
+	meta = InMeta;
+	morphName.Reset();
+	for (auto &b : bind) {
+		b.Reset();
+	}
+	if (meta == nullptr) {
 		return;
 	}
 
-	USkeletalMeshComponent *skc = GetOwningComponent();
-	//auto &morphMap = skc->GetMorphTargetCurves();
-	for (auto &a : MetaObject->BlendShapeGroup) {
-		if (a.name != shapeBlend[(int)type]) {
+	for (int type = 0; type < (int)EVrmMorphGroupType::Num; ++type) {
+		for (auto &a : meta->BlendShapeGroup) {
+			if (a.name != shapeBlend[type]) {
+				continue;
+			}
+			for (auto &b : a.BlendShape) {
+				const FName name(*b.morphTargetName);
+				int32 morphIndex = morphName.Find(name);
+				if (morphIndex == INDEX_NONE) {
+					morphIndex = morphName.Add(name);
+				}
+
+				const float w = b.weight / 100.f;
+				auto *p = bind[type].FindByPredicate([morphIndex](const FBind &c) { return c.morphIndex == morphIndex; });
+				if (p) {
+					p->weight += w;
+				} else {
+					FBind c;
+					c.morphIndex = morphIndex;
+					c.weight = w;
+					bind[type].Add(c);
+				}
+			}
+		}
+	}
+}
+
+void FVrmExpressionTable::Evaluate(const float *groupWeight, TArray<float> &morphWeight) const {
+	morphWeight.SetNumUninitialized(morphName.Num(), false);
+	FMemory::Memzero(morphWeight.GetData(), morphWeight.Num() * sizeof(float));
+
+	for (int type = 0; type < (int)EVrmMorphGroupType::Num; ++type) {
+		const float g = groupWeight[type];
+		if (g == 0.f) {
 			continue;
 		}
+		for (const auto &b : bind[type]) {
+			morphWeight[b.morphIndex] += g * b.weight;
+		}
+	}
+}
 
-		for (auto &b : a.BlendShape) {
-			//b.meshName
+bool UVrmAnimInstance::UpdateExpressionTable() {
+	if (MetaObject == nullptr) {
+		return false;
+	}
+	if (ExpressionTable.meta != MetaObject) {
+		ExpressionTable.Build(MetaObject);
+		ExpressionWeight.Init(0.f, (int)EVrmMorphGroupType::Num);
+		MorphWeight.Init(0.f, ExpressionTable.morphName.Num());
+	}
+	return true;
+}
 
-			SetMorphTarget(*(b.morphTargetName), Value);
+void UVrmAnimInstance::PushMorphWeight() {
+	for (int i = 0; i < MorphWeight.Num(); ++i) {
+		SetMorphTarget(ExpressionTable.morphName[i], MorphWeight[i]);
+	}
+}
 
-			/*
-			for (auto &m : skc->SkeletalMesh->MorphTargets) {
-				auto s = m->GetName();
-				//if (s.Find(b.meshName) < 0) {
-				//	continue;
-				//}
-				auto s1 = FString::Printf(TEXT("%02d_"), b.meshID);
-				if (s.Find(s1) < 0) {
-					continue;
-				}
-				auto s2 = FString::Printf(TEXT("_%02d"), b.shapeIndex);
-				if (s.Find(s2) < 0) {
-					continue;
-				}
-				SetMorphTarget(*s, Value);
-			}
-			*/
+void UVrmAnimInstance::SetMorphTargetVRM(EVrmMorphGroupType type, float Value) {
+	if (type >= EVrmMorphGroupType::Num || UpdateExpressionTable() == false) {
+		return;
+	}
+
+	// only the morphs of this group change
+	const int t = (int)type;
+	const float delta = Value - ExpressionWeight[t];
+	ExpressionWeight[t] = Value;
+	for (const auto &b : ExpressionTable.bind[t]) {
+		MorphWeight[b.morphIndex] += delta * b.weight;
+		SetMorphTarget(ExpressionTable.morphName[b.morphIndex], MorphWeight[b.morphIndex]);
+	}
+}
+
+void UVrmAnimInstance::SetMorphTargetVRMBatch(const TArray<float> &Values) {
+	if (UpdateExpressionTable() == false) {
+		return;
+	}
+
+	for (int i = 0; i < ExpressionWeight.Num(); ++i) {
+		ExpressionWeight[i] = Values.IsValidIndex(i) ? Values[i] : 0.f;
+	}
+	ExpressionTable.Evaluate(ExpressionWeight.GetData(), MorphWeight);
+	PushMorphWeight();
+}
+
+bool FVrmExpressionStream::Push(double time, const float *weight, int32 num) {
+	const int32 w = writeIndex;
+	const int32 next = (w + 1) % FrameNum;
+	if (next == readIndex) {
+		return false;
+	}
+
+	auto &f = frame[w];
+	f.time = time;
+	for (int i = 0; i < (int)EVrmMorphGroupType::Num; ++i) {
+		f.weight[i] = (i < num) ? weight[i] : 0.f;
+	}
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&writeIndex, next);
+	return true;
+}
+
+bool FVrmExpressionStream::Sample(double time, float *outWeight, double *outSampleTime) {
+	const int32 w = writeIndex;
+	FPlatformMisc::MemoryBarrier();
+
+	int32 r = readIndex;
+	if (r == w) {
+		return false;
+	}
+
+	// skip frames that have a newer one before time
+	int32 next = (r + 1) % FrameNum;
+	while (next != w && frame[next].time <= time) {
+		r = next;
+		next = (r + 1) % FrameNum;
+	}
+
+	const auto &a = frame[r];
+	if (next == w || time <= a.time) {
+		FMemory::Memcpy(outWeight, a.weight, sizeof(a.weight));
+		if (outSampleTime) {
+			*outSampleTime = a.time;
+		}
+	} else {
+		const auto &b = frame[next];
+		if (outSampleTime) {
+			*outSampleTime = time;
+		}
+		const float alpha = (float)FMath::Clamp((time - a.time) / FMath::Max(b.time - a.time, 1.e-6), 0.0, 1.0);
+		for (int i = 0; i < (int)EVrmMorphGroupType::Num; ++i) {
+			outWeight[i] = FMath::Lerp(a.weight[i], b.weight[i], alpha);
 		}
 	}
 
+	// frame r stays readable. the producer stops before it
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&readIndex, r);
+	return true;
+}
 
+bool UVrmAnimInstance::PushExpressionFrame(double Time, const float *Weights, int32 Num) {
+	return ExpressionStream.Push(Time, Weights, Num);
 }
 
 void UVrmAnimInstance::SetVrmData(USkeletalMeshComponent *baseSkeletalMesh, UVrmMetaObject *meta) {
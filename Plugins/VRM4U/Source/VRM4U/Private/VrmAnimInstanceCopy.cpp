@@ -11,6 +11,8 @@
 //#include "BoneControllers/AnimNode_TwoBoneIK.h"
 //#include "BoneControllers/AnimNode_SplineIK.h"
 #include "AnimNode_VrmSpringBone.h"
+#include "VrmPoseSnapshot.h"
+#include "VrmRetargetBroadcaster.h"
 
 
 namespace {
@@ -151,37 +153,161 @@ namespace {
 }
 
 namespace {
-	// for UE4.19-4.22
-	template<class BaseType, class PoseType>
-	static void ConvertToLocalPoses(const BaseType &basePose, PoseType& OutPose)
-	{
-		checkSlow(basePose.Pose.IsValid());
-		OutPose = basePose.GetPose();
-
-		// now we need to convert back to local bases
-		// only convert back that has been converted to mesh base
-		// if it was local base, and if it hasn't been modified
-		// that is still okay even if parent is changed, 
-		// that doesn't mean this local has to change
-		// go from child to parent since I need parent inverse to go back to local
-		// root is same, so no need to do Index == 0
-		const FCSPose<FCompactPose>::BoneIndexType RootBoneIndex(0);
-		if (basePose.GetComponentSpaceFlags()[RootBoneIndex])
-		{
-			OutPose[RootBoneIndex] = basePose.GetPose()[RootBoneIndex];
+	// component space after the spring output, memoized in csPose.
+	// bones below the first output bone are untouched, so their cached value holds
+	FTransform GetSpringOutputCS(FCSPose<FCompactPose> &csPose, const FCompactPose &localPose, TBitArray<> &updated, int32 firstIndex, FCompactPoseBoneIndex index) {
+		if (index.GetInt() < firstIndex || updated[index.GetInt()]) {
+			return csPose.GetComponentSpaceTransform(index);
 		}
+		// may sit below an output bone. rebuild from the local pose
+		const FCompactPoseBoneIndex parent = localPose.GetParentBoneIndex(index);
+		FTransform t = localPose[index];
+		if (parent != INDEX_NONE) {
+			t = t * GetSpringOutputCS(csPose, localPose, updated, firstIndex, parent);
+		}
+		csPose.SetComponentSpaceTransform(index, t);
+		updated[index.GetInt()] = true;
+		return t;
+	}
 
-		const int32 NumBones = basePose.GetPose().GetNumBones();
-		for (int32 Index = NumBones - 1; Index > 0; Index--)
-		{
-			const FCSPose<FCompactPose>::BoneIndexType BoneIndex(Index);
-			if (basePose.GetComponentSpaceFlags()[BoneIndex])
-			{
-				const FCSPose<FCompactPose>::BoneIndexType ParentIndex = basePose.GetPose().GetParentBoneIndex(BoneIndex);
-				OutPose[BoneIndex].SetToRelativeTransform(OutPose[ParentIndex]);
-				OutPose[BoneIndex].NormalizeRotation();
+	// write back only the bones the spring solver modified. bones are sorted by compact index
+	void ApplySpringOutput(FCSPose<FCompactPose> &csPose, const TArray<FBoneTransform> &bones, FCompactPose &OutPose) {
+		if (bones.Num() == 0) {
+			return;
+		}
+		const int32 firstIndex = bones[0].BoneIndex.GetInt();
+		TBitArray<> updated(false, OutPose.GetNumBones());
+
+		for (const auto &b : bones) {
+			FTransform local = b.Transform;
+			const FCompactPoseBoneIndex parent = OutPose.GetParentBoneIndex(b.BoneIndex);
+			if (parent != INDEX_NONE) {
+				local.SetToRelativeTransform(GetSpringOutputCS(csPose, OutPose, updated, firstIndex, parent));
 			}
+			local.NormalizeRotation();
+			OutPose[b.BoneIndex] = local;
+
+			csPose.SetComponentSpaceTransform(b.BoneIndex, b.Transform);
+			updated[b.BoneIndex.GetInt()] = true;
+		}
+	}
+}
+
+void FVrmHumanoidPose::Init(int32 num) {
+	rotation.SetNumUninitialized(num, false);
+	bValid.Init(0, num);
+	hipTranslation = FVector::ZeroVector;
+}
+
+int32 FVrmHumanoidMap::GetHumanoidBoneNum() {
+	return sizeof(table) / sizeof(table[0]);
+}
+
+bool FVrmHumanoidMap::IsValid(const UVrmMetaObject *InMeta, const USkeletalMesh *InMesh) const {
+	return meta == InMeta && mesh == InMesh;
+}
+
+void FVrmHumanoidMap::Reset() {
+	bone.Reset();
+	hipLocalHeight = hipHeight = 1.f;
+	meta = nullptr;
+	mesh = nullptr;
+	compactBoneIndices.Reset();
+}
+
+void FVrmHumanoidMap::Build(const UVrmMetaObject *InMeta, const USkeletalMesh *InMesh) {
+	Reset();
+	meta = InMeta;
+	mesh = InMesh;
+
+	// ref pose
+	const auto &RefSkeleton = mesh->RefSkeleton;
+	const auto &RefSkeletonTransform = RefSkeleton.GetRefBonePose();
+
+	int BoneCount = 0;
+	for (const auto &t : table) {
+		++BoneCount;
+		const auto *name = meta->humanoidBoneTable.Find(t);
+		if (name == nullptr) {
+			continue;
+		}
+
+		FBone b;
+		b.humanoidIndex = BoneCount - 1;
+		b.boneIndex = RefSkeleton.FindBoneIndex(**name);
+		if (b.boneIndex == INDEX_NONE) {
+			continue;
+		}
+		b.parentIndex = RefSkeleton.GetParentIndex(b.boneIndex);
+		b.ref = RefSkeletonTransform[b.boneIndex];
+		b.refRotationInv = b.ref.GetRotation().Inverse();
+
+		// hips moves with the source. scaled by the hip height
+		if (BoneCount == 1) {
+			hipLocalHeight = b.ref.GetLocation().Z;
+
+			int32_t p = b.boneIndex;
+			float HipHeight = 0;
+			while(p != INDEX_NONE){
+				HipHeight += RefSkeletonTransform[p].GetLocation().Z;
+				p = RefSkeleton.GetParentIndex(p);
+			}
+			hipHeight = HipHeight;
+		}
+		bone.Add(b);
+	}
+}
+
+void FVrmHumanoidMap::ResolveCompactIndex(const FBoneContainer &RequiredBones) {
+	// a LOD switch can keep the count and change the bones
+	const auto &boneIndices = RequiredBones.GetBoneIndicesArray();
+	if (compactBoneIndices == boneIndices) {
+		return;
+	}
+	compactBoneIndices = boneIndices;
+
+	for (auto &b : bone) {
+		b.compactIndex = FCompactPoseBoneIndex(boneIndices.Find((FBoneIndexType)b.boneIndex));
+	}
+}
+
+void FVrmHumanoidMap::Decode(const TArray<FTransform> &pose, bool bLocal, FVrmHumanoidPose &out) const {
+	out.Init(GetHumanoidBoneNum());
+
+	for (const auto &b : bone) {
+		if (pose.IsValidIndex(b.boneIndex) == false) {
+			continue;
+		}
+
+		// parent bone space
+		FTransform srcCurrentTrans = pose[b.boneIndex];
+		if (bLocal == false && pose.IsValidIndex(b.parentIndex)) {
+			srcCurrentTrans = srcCurrentTrans.GetRelativeTransform(pose[b.parentIndex]);
+		}
+
+		out.rotation[b.humanoidIndex] = srcCurrentTrans.GetRotation() * b.refRotationInv;
+		out.bValid[b.humanoidIndex] = 1;
+
+		if (b.humanoidIndex == 0) {
+			out.hipTranslation = (srcCurrentTrans.GetLocation() - b.ref.GetLocation()) / hipLocalHeight;
+		}
+	}
+}
+
+void FVrmHumanoidMap::Apply(const FVrmHumanoidPose &in, FCompactPose &pose) const {
+	for (const auto &b : bone) {
+		if (b.compactIndex == INDEX_NONE || in.bValid.IsValidIndex(b.humanoidIndex) == false || in.bValid[b.humanoidIndex] == 0) {
+			continue;
 		}
+
+		FTransform dstTrans = b.ref;
+		dstTrans.SetRotation(dstTrans.GetRotation() * in.rotation[b.humanoidIndex]);
+
+		if (b.humanoidIndex == 0) {
+			dstTrans.SetTranslation(b.ref.GetLocation() + in.hipTranslation * hipHeight);
+		}
+
+		pose[b.compactIndex] = dstTrans;
 	}
 }
 
@@ -228,87 +354,35 @@ bool FVrmAnimInstanceCopyProxy::Evaluate(FPoseContext& Output) {
 		return false;
 	}
 
-	// ref pose
-	const auto &dstRefSkeletonTransform = GetSkelMeshComponent()->SkeletalMesh->RefSkeleton.GetRefBonePose();
-	const auto &srcRefSkeletonTransform = srcSkeletalMeshComp->SkeletalMesh->RefSkeleton.GetRefBonePose();
-
-	auto &pose = Output.Pose;
-
-	int BoneCount = 0;
-	for (const auto &t : table) {
-		FName srcName, dstName;
-		srcName = dstName = NAME_None;
-
-		++BoneCount;
-		{
-			auto a = srcMeta->humanoidBoneTable.Find(t);
-			if (a) {
-				srcName = **a;
-			}
-		}
-		//auto srcName = srcSkeletalMeshComp->SkeletalMesh->Skeleton->GetRigBoneMapping(t);
-		if (srcName == NAME_None) {
-			continue;
-		}
-
-		{
-			auto a = dstMeta->humanoidBoneTable.Find(t);
-			if (a) {
-				dstName = **a;
-			}
-		}
-		//auto dstName = GetSkelMeshComponent()->SkeletalMesh->Skeleton->GetRigBoneMapping(t);
-		if (dstName == NAME_None) {
-			continue;
-		}
-
-		auto dstIndex = GetSkelMeshComponent()->GetBoneIndex(dstName);
-		if (dstIndex < 0) {
-			continue;
-		}
-		auto srcIndex = srcSkeletalMeshComp->GetBoneIndex(srcName);
-		if (srcIndex < 0) {
-			continue;
-		}
-
-
-		const auto srcCurrentTrans = srcSkeletalMeshComp->GetSocketTransform(srcName, RTS_ParentBoneSpace);
-		const auto srcRefTrans = srcRefSkeletonTransform[srcIndex];
-		const auto dstRefTrans = dstRefSkeletonTransform[dstIndex];
-
-		FTransform dstTrans = dstRefTrans;
+	const USkeletalMesh *srcMesh = srcSkeletalMeshComp->SkeletalMesh;
+	const USkeletalMesh *dstMesh = GetSkelMeshComponent()->SkeletalMesh;
+	if (srcMesh == nullptr || dstMesh == nullptr) {
+		return false;
+	}
+	if (DstMap.IsValid(dstMeta, dstMesh) == false) {
+		DstMap.Build(dstMeta, dstMesh);
+	}
+	DstMap.ResolveCompactIndex(Output.Pose.GetBoneContainer());
 
-		{
-			FQuat diff = srcCurrentTrans.GetRotation()*srcRefTrans.GetRotation().Inverse();
-			dstTrans.SetRotation(dstTrans.GetRotation()*diff);
+	const FVrmHumanoidPose *humanoidPose = nullptr;
+	if (SrcBroadcaster && SrcBroadcaster->GetHumanoidPose().bValid.Num() > 0) {
+		// decoded once for all copies
+		humanoidPose = &SrcBroadcaster->GetHumanoidPose();
+	} else {
+		if (SrcMap.IsValid(srcMeta, srcMesh) == false) {
+			SrcMap.Build(srcMeta, srcMesh);
 		}
-		//dstTrans.SetLocation(dstRefTrans.GetLocation());// +srcCurrentTrans.GetLocation() - srcRefTrans.GetLocation());
-
-		//FVector newLoc = dstTrans.GetLocation();
-		if (BoneCount==1){
-			int32_t p = dstIndex;
-			float HipHeight = 0;
-			while(p != INDEX_NONE){
-
-				HipHeight += dstRefSkeletonTransform[p].GetLocation().Z;
-				p = GetSkelMeshComponent()->SkeletalMesh->RefSkeleton.GetParentIndex(p);
-			}
-			//FVector diff = srcCurrentTrans.GetLocation() - srcRefTrans.GetLocation();
-			//FVector scale = dstRefTrans.GetLocation() / srcRefTrans.GetLocation();
-			FVector diff = srcCurrentTrans.GetLocation() - srcRefTrans.GetLocation();
-			float scale = HipHeight / srcRefTrans.GetLocation().Z;
-			dstTrans.SetTranslation(dstRefTrans.GetLocation() + diff * scale);
-			//if (newLoc.Normalize()) {
-				//auto dstRefLocation = dstRefTrans.GetLocation();
-				//newLoc *= dstRefLocation.Size();
-				//dstTrans.SetLocation(newLoc);
-			//}
+		// published pose. no access to the source component while it evaluates
+		if (SrcPoseSnapshot && SrcPoseSnapshot->GetLocalPose().Num() == srcMesh->RefSkeleton.GetNum()) {
+			SrcMap.Decode(SrcPoseSnapshot->GetLocalPose(), true, HumanoidPose);
+		} else {
+			SrcMap.Decode(srcSkeletalMeshComp->GetComponentSpaceTransforms(), false, HumanoidPose);
 		}
-
-		FCompactPose::BoneIndexType bi(dstIndex);
-		pose[bi] = dstTrans;
+		humanoidPose = &HumanoidPose;
 	}
 
+	DstMap.Apply(*humanoidPose, Output.Pose);
+
 	if (bIgnoreVRMSwingBone == false){
 		if (SpringBoneNode.Get() == nullptr) {
 			SpringBoneNode = MakeShareable(new FAnimNode_VrmSpringBone());
@@ -320,12 +394,9 @@ bool FVrmAnimInstanceCopyProxy::Evaluate(FPoseContext& Output) {
 			springBone.VrmMetaObject = dstMeta;
 			springBone.bCallByAnimInstance = true;
 
-			// Evaluate the child and convert
-			//FComponentSpacePoseContext InputCSPose(Output.AnimInstanceProxy);
 			FComponentSpacePoseContext InputCSPose(this);
 			FAnimationInitializeContext InitContext(this);
-			//f.EvaluateSkeletalControl_AnyThread(
-			
+
 			if (springBone.IsSprintInit() == false) {
 				springBone.Initialize_AnyThread(InitContext);
 				springBone.ComponentPose.SetLinkNode(&springBone);
@@ -333,14 +404,11 @@ bool FVrmAnimInstanceCopyProxy::Evaluate(FPoseContext& Output) {
 
 			springBone.CurrentDeltaTime = CurrentDeltaTime;
 
+			// component space is computed on demand. only the spring chains and their ancestors
 			InputCSPose.Pose.InitPose(Output.Pose);
-			springBone.EvaluateComponentSpace_AnyThread(InputCSPose);
-			//Output.Pose.InitFrom(InputCSPose.Pose);
-			//InputCSPose.Pose.ConvertToLocalPoses(Output.Pose);
-			ConvertToLocalPoses(InputCSPose.Pose, Output.Pose);
-			//checkSlow( InputCSPose.Pose.GetPose().IsValid() );
-			//InputCSPose.Pose.ConvertToLocalPoses(Output.Pose);
-			//Output.Curve = InputCSPose.Curve;
+			springBone.BoneTransformsSpring.Reset();
+			springBone.EvaluateSkeletalControl_AnyThread(InputCSPose, springBone.BoneTransformsSpring);
+			ApplySpringOutput(InputCSPose.Pose, springBone.BoneTransformsSpring, Output.Pose);
 		}
 	} else {
 		SpringBoneNode = nullptr;
@@ -375,6 +443,29 @@ FAnimInstanceProxy* UVrmAnimInstanceCopy::CreateAnimInstanceProxy() {
 void UVrmAnimInstanceCopy::NativeInitializeAnimation() {
 }
 void UVrmAnimInstanceCopy::NativeUpdateAnimation(float DeltaSeconds) {
+	SrcBroadcaster = nullptr;
+	if (bUseRetargetBroadcaster && SrcSkeletalMeshComponent && SrcVrmAssetList) {
+		SrcBroadcaster = UVrmRetargetBroadcaster::Get(SrcSkeletalMeshComponent, SrcVrmAssetList->VrmMetaObject);
+	}
+	if (myProxy) {
+		myProxy->SrcBroadcaster = SrcBroadcaster;
+	}
+
+	if (bUseSourcePoseSnapshot && SrcBroadcaster == nullptr && SrcSkeletalMeshComponent) {
+		if (SrcPoseSnapshot == nullptr || SrcPoseSnapshot->GetSource() != SrcSkeletalMeshComponent) {
+			SrcPoseSnapshot = UVrmPoseSnapshot::Get(SrcSkeletalMeshComponent);
+		}
+	} else {
+		SrcPoseSnapshot = nullptr;
+	}
+	if (myProxy) {
+		myProxy->SrcPoseSnapshot = SrcPoseSnapshot;
+	}
+
+	if (myProxy && myProxy->SpringBoneNode.Get()) {
+		// not in the anim graph. call game thread update by hand
+		myProxy->SpringBoneNode->PreUpdate(this);
+	}
 }
 void UVrmAnimInstanceCopy::NativePostEvaluateAnimation() {
 }
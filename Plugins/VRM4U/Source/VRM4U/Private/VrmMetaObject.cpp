@@ -2,7 +2,74 @@
 
 
 #include "VrmMetaObject.h"
+#include "ReferenceSkeleton.h"
+#include "Engine/SkeletalMesh.h"
 
 
+void UVrmMetaObject::BakeSpringBone(const FReferenceSkeleton &RefSkeleton) {
+	BakeSpringBone(RefSkeleton, VRMSpringMeta, VRMSpringBake);
+	++SpringBakeVersion;
+}
 
+void UVrmMetaObject::BakeSpringBone(const FReferenceSkeleton &RefSkeleton, const TArray<FVRMSpringMeta> &SpringMeta, FVRMSpringBake &Bake) {
+	Bake = FVRMSpringBake();
 
+	const auto &RefSkeletonTransform = RefSkeleton.GetRefBonePose();
+
+	// first child of each bone. one pass over the skeleton
+	TArray<int32> firstChild;
+	firstChild.Init(INDEX_NONE, RefSkeleton.GetNum());
+	for (int32 i = RefSkeleton.GetNum() - 1; i > 0; --i) {
+		const int32 parent = RefSkeleton.GetParentIndex(i);
+		if (parent != INDEX_NONE) {
+			firstChild[parent] = i;
+		}
+	}
+
+	for (const auto &metaS : SpringMeta) {
+		Bake.springChainStart.Add(Bake.chainJointStart.Num());
+
+		for (const auto &rootName : metaS.boneNames) {
+			const int32 start = Bake.jointBoneIndex.Num();
+
+			//root and children
+			int32 boneIndex = RefSkeleton.FindBoneIndex(*rootName);
+			for (int chainCount = 0; chainCount < 100 && boneIndex != INDEX_NONE; ++chainCount) {
+				FVector axis = RefSkeletonTransform[boneIndex].GetLocation() * 0.7f;
+				if (firstChild[boneIndex] != INDEX_NONE) {
+					axis = RefSkeletonTransform[firstChild[boneIndex]].GetLocation();
+				}
+				Bake.jointBoneName.Add(RefSkeleton.GetBoneName(boneIndex));
+				Bake.jointBoneIndex.Add(boneIndex);
+				Bake.jointBoneAxis.Add(axis);
+				Bake.jointLength.Add(axis.Size());
+
+				boneIndex = firstChild[boneIndex];
+			}
+
+			if (Bake.jointBoneIndex.Num() > start) {
+				Bake.chainJointStart.Add(start);
+				Bake.chainJointNum.Add(Bake.jointBoneIndex.Num() - start);
+			}
+		}
+		Bake.springChainNum.Add(Bake.chainJointStart.Num() - Bake.springChainStart.Last());
+	}
+}
+
+bool UVrmMetaObject::IsSpringBoneBaked() const {
+	return VRMSpringBake.springChainStart.Num() == VRMSpringMeta.Num()
+		&& VRMSpringBake.springChainStart.Num() > 0;
+}
+
+#if WITH_EDITOR
+void UVrmMetaObject::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) {
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	if (SkeletalMesh) {
+		BakeSpringBone(SkeletalMesh->RefSkeleton);
+	} else {
+		// collider edits
+		++SpringBakeVersion;
+	}
+}
+#endif
@@ -0,0 +1,57 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#include "VrmPoseSnapshot.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+
+namespace {
+	TMap<TWeakObjectPtr<USkeletalMeshComponent>, TWeakObjectPtr<UVrmPoseSnapshot>> SnapshotMap;
+}
+
+UVrmPoseSnapshot *UVrmPoseSnapshot::Get(USkeletalMeshComponent *Source) {
+	check(IsInGameThread());
+	if (Source == nullptr) {
+		return nullptr;
+	}
+
+	for (auto it = SnapshotMap.CreateIterator(); it; ++it) {
+		if (it.Key().IsValid() == false || it.Value().IsValid() == false) {
+			it.RemoveCurrent();
+		}
+	}
+
+	auto *p = SnapshotMap.Find(Source);
+	if (p) {
+		return p->Get();
+	}
+
+	UVrmPoseSnapshot *s = NewObject<UVrmPoseSnapshot>(Source);
+	s->Source = Source;
+	Source->OnBoneTransformsFinalized.AddDynamic(s, &UVrmPoseSnapshot::Publish);
+	SnapshotMap.Add(Source, s);
+	return s;
+}
+
+void UVrmPoseSnapshot::Publish() {
+	const USkeletalMeshComponent *comp = Source.Get();
+	if (comp == nullptr || comp->SkeletalMesh == nullptr) {
+		return;
+	}
+	const auto &RefSkeleton = comp->SkeletalMesh->RefSkeleton;
+	const auto &componentSpace = comp->GetComponentSpaceTransforms();
+
+	const int32 back = 1 - Front;
+	auto &local = Buffer[back];
+	local.SetNumUninitialized(componentSpace.Num(), false);
+	for (int i = 0; i < componentSpace.Num(); ++i) {
+		const int32 parent = RefSkeleton.GetParentIndex(i);
+		if (componentSpace.IsValidIndex(parent)) {
+			local[i] = componentSpace[i].GetRelativeTransform(componentSpace[parent]);
+		} else {
+			local[i] = componentSpace[i];
+		}
+	}
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&Front, back);
+}
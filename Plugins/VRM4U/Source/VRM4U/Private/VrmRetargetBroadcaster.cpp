@@ -0,0 +1,54 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#include "VrmRetargetBroadcaster.h"
+#include "VrmMetaObject.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+
+namespace {
+	TMap<TWeakObjectPtr<USkeletalMeshComponent>, TWeakObjectPtr<UVrmRetargetBroadcaster>> BroadcasterMap;
+}
+
+UVrmRetargetBroadcaster *UVrmRetargetBroadcaster::Get(USkeletalMeshComponent *Source, const UVrmMetaObject *SourceMeta) {
+	check(IsInGameThread());
+	if (Source == nullptr || SourceMeta == nullptr) {
+		return nullptr;
+	}
+
+	for (auto it = BroadcasterMap.CreateIterator(); it; ++it) {
+		if (it.Key().IsValid() == false || it.Value().IsValid() == false) {
+			it.RemoveCurrent();
+		}
+	}
+
+	UVrmRetargetBroadcaster *b = nullptr;
+	auto *p = BroadcasterMap.Find(Source);
+	if (p) {
+		b = p->Get();
+	} else {
+		b = NewObject<UVrmRetargetBroadcaster>(Source);
+		b->Source = Source;
+		Source->OnBoneTransformsFinalized.AddDynamic(b, &UVrmRetargetBroadcaster::Publish);
+		BroadcasterMap.Add(Source, b);
+	}
+	// the last copy wins when copies disagree on the source meta
+	b->SourceMeta = SourceMeta;
+	return b;
+}
+
+void UVrmRetargetBroadcaster::Publish() {
+	const USkeletalMeshComponent *comp = Source.Get();
+	const UVrmMetaObject *meta = SourceMeta.Get();
+	if (comp == nullptr || comp->SkeletalMesh == nullptr || meta == nullptr) {
+		return;
+	}
+	if (SrcMap.IsValid(meta, comp->SkeletalMesh) == false) {
+		SrcMap.Build(meta, comp->SkeletalMesh);
+	}
+
+	const int32 back = 1 - Front;
+	SrcMap.Decode(comp->GetComponentSpaceTransforms(), false, Buffer[back]);
+
+	FPlatformMisc::MemoryBarrier();
+	FPlatformAtomics::InterlockedExchange(&Front, back);
+}
@@ -0,0 +1,204 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+#include "VrmSpringBoneSolver.h"
+
+// vrm4u.SpringBoneBenchmark [joints] [colliders] [frames] [loopc]
+// synthetic avatar on the solver core only. no pose, no world
+
+namespace {
+	using namespace VRMSpringSolver;
+
+	const int32 BenchChainLength = 8;
+
+	struct FBenchAvatar {
+		TArray<TArray<int32>> jointByDepth;
+		TArray<int32> parent;			// INDEX_NONE for chain root
+		TArray<int32> chain;
+		TArray<FVector> axis;			// rest direction * length
+		TArray<float> length;
+		TArray<FVector> curTail;
+		TArray<FVector> prevTail;
+		TArray<FQuat> rot;
+
+		TArray<FVector> rootPos;		// per chain
+		TArray<FVector> sphereCenter;
+		TArray<float> sphereRadius;
+
+		void Build(int32 jointNum, int32 colliderNum) {
+			FRandomStream rand(1234);
+
+			const int32 chainNum = FMath::DivideAndRoundUp(jointNum, BenchChainLength);
+			for (int c = 0; c < chainNum; ++c) {
+				rootPos.Add(FVector(rand.FRandRange(-20.f, 20.f), rand.FRandRange(-20.f, 20.f), 150.f));
+				const int32 num = FMath::Min(BenchChainLength, jointNum - c * BenchChainLength);
+				for (int d = 0; d < num; ++d) {
+					const int32 j = parent.Add(d == 0 ? INDEX_NONE : parent.Num() - 1);
+					chain.Add(c);
+					length.Add(rand.FRandRange(3.f, 6.f));
+					axis.Add(FVector(0, 0, -length[j]));
+					const FVector tail = rootPos[c] + FVector(0, 0, -(d + 1) * 5.f);
+					curTail.Add(tail);
+					prevTail.Add(tail);
+					rot.Add(FQuat::Identity);
+
+					if (jointByDepth.Num() <= d) {
+						jointByDepth.SetNum(d + 1);
+					}
+					jointByDepth[d].Add(j);
+				}
+			}
+			for (int i = 0; i < colliderNum; ++i) {
+				sphereCenter.Add(FVector(rand.FRandRange(-30.f, 30.f), rand.FRandRange(-30.f, 30.f), rand.FRandRange(100.f, 150.f)));
+				sphereRadius.Add(rand.FRandRange(3.f, 10.f));
+			}
+		}
+
+		FVector Head(int32 j) const {
+			return (parent[j] == INDEX_NONE) ? rootPos[chain[j]] : curTail[parent[j]];
+		}
+
+		void Step(float DeltaTime, const FVector &rootMove, bool bSIMD) {
+			for (auto &p : rootPos) {
+				p += rootMove;
+			}
+			const float dragForce = 0.4f;
+			const float stiffnessForce = 1.f * DeltaTime * 10.f;
+			const FVector external = FVector(0, 0, -1.f) * DeltaTime * 100.f;
+
+			for (const auto &depth : jointByDepth) {
+				for (int batch = 0; batch < depth.Num(); batch += SpringLaneNum) {
+					const int laneNum = FMath::Min(SpringLaneNum, depth.Num() - batch);
+
+					FSpringLane L;
+					int32 laneJoint[SpringLaneNum];
+					for (int lane = 0; lane < SpringLaneNum; ++lane) {
+						const int32 j = depth[batch + (lane < laneNum ? lane : 0)];
+						laneJoint[lane] = j;
+						L.SetCur(lane, curTail[j]);
+						L.SetPrev(lane, prevTail[j]);
+						L.SetHead(lane, Head(j));
+						L.SetAxis(lane, axis[j]);
+						L.length[lane] = length[j];
+					}
+
+					if (bSIMD) {
+						SpringVerletSIMD(L, dragForce, stiffnessForce, external);
+					} else {
+						SpringVerletScalar(L, SpringLaneNum, dragForce, stiffnessForce, external);
+					}
+
+					FSpringRotLane R;
+					for (int lane = 0; lane < SpringLaneNum; ++lane) {
+						const int32 j = laneJoint[lane];
+						const FVector head = Head(j);
+						FVector nextTail = L.GetNext(lane);
+						for (int i = 0; i < sphereCenter.Num(); ++i) {
+							nextTail = SpringCollideSphere(head, length[j], nextTail, sphereCenter[i], sphereRadius[i] + 1.f);
+						}
+						if (lane < laneNum) {
+							prevTail[j] = curTail[j];
+							curTail[j] = nextTail;
+						}
+						const FVector a = axis[j].GetSafeNormal();
+						const FVector b = (nextTail - head).GetSafeNormal();
+						R.aX[lane] = a.X; R.aY[lane] = a.Y; R.aZ[lane] = a.Z;
+						R.bX[lane] = b.X; R.bY[lane] = b.Y; R.bZ[lane] = b.Z;
+					}
+
+					const int validMask = bSIMD ? SpringFindBetweenSIMD(R) : 0;
+					for (int lane = 0; lane < laneNum; ++lane) {
+						if (validMask & (1 << lane)) {
+							rot[laneJoint[lane]] = FQuat(R.qX[lane], R.qY[lane], R.qZ[lane], R.qW[lane]);
+						} else {
+							rot[laneJoint[lane]] = FQuat::FindBetween(FVector(R.aX[lane], R.aY[lane], R.aZ[lane]), FVector(R.bX[lane], R.bY[lane], R.bZ[lane]));
+						}
+					}
+				}
+			}
+		}
+
+		// returns seconds
+		double Run(int32 frames, int32 loopc, bool bSIMD) {
+			const float DeltaTime = 1.f / 60.f;
+			const double start = FPlatformTime::Seconds();
+			for (int f = 0; f < frames; ++f) {
+				// sway the roots so that chains do not rest
+				const FVector rootMove(FMath::Sin(f * 0.1f) * 2.f, FMath::Cos(f * 0.13f) * 2.f, 0.f);
+				for (int i = 0; i < loopc; ++i) {
+					Step(DeltaTime / loopc, rootMove / (float)loopc, bSIMD);
+				}
+			}
+			return FPlatformTime::Seconds() - start;
+		}
+	};
+
+	void SpringBoneBenchmark(const TArray<FString>& Args) {
+		const int32 jointNum = FMath::Clamp(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300, 1, 2000);
+		const int32 colliderNum = FMath::Clamp(Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 20, 0, 100);
+		const int32 frames = FMath::Max(1, Args.Num() > 2 ? FCString::Atoi(*Args[2]) : 600);
+		const int32 loopc = FMath::Max(1, Args.Num() > 3 ? FCString::Atoi(*Args[3]) : 1);
+
+		FBenchAvatar scalar, simd;
+		scalar.Build(jointNum, colliderNum);
+		simd.Build(jointNum, colliderNum);
+
+		const double scalarSec = scalar.Run(frames, loopc, false);
+		const double simdSec = simd.Run(frames, loopc, true);
+
+		// drift between the two paths over the whole run. see SpringLaneNum
+		float maxError = 0.f;
+		for (int j = 0; j < jointNum; ++j) {
+			maxError = FMath::Max(maxError, (scalar.curTail[j] - simd.curTail[j]).Size() / scalar.length[j]);
+		}
+
+		const double jointStep = (double)jointNum * frames * loopc;
+		UE_LOG(LogTemp, Log, TEXT("VRM4U: SpringBoneBenchmark joints=%d colliders=%d frames=%d loopc=%d"), jointNum, colliderNum, frames, loopc);
+		UE_LOG(LogTemp, Log, TEXT("VRM4U:   scalar %.1f ns/joint-substep"), scalarSec * 1.e9 / jointStep);
+		UE_LOG(LogTemp, Log, TEXT("VRM4U:   simd   %.1f ns/joint-substep"), simdSec * 1.e9 / jointStep);
+		UE_LOG(LogTemp, Log, TEXT("VRM4U:   max tail error %g (relative to bone length)"), maxError);
+	}
+
+	FAutoConsoleCommand SpringBoneBenchmarkCommand(
+		TEXT("vrm4u.SpringBoneBenchmark"),
+		TEXT("Run the spring bone solver on a synthetic avatar. args: joints(1-2000) colliders(0-100) frames loopc"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&SpringBoneBenchmark));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVrmSpringBoneSolverTest, "VRM4U.SpringBone.Solver", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVrmSpringBoneSolverTest::RunTest(const FString& Parameters) {
+	// 4 chains, 8 colliders, 120 frames. tail of each chain end, from the scalar path.
+	// InvSqrt differs per cpu (rsqrt estimate), so compare within a tolerance
+	static const FVector expected[] = {
+		FVector(16.5561f, 0.4618f, 117.1377f),
+		FVector(4.3415f, 32.5591f, 115.7320f),
+		FVector(2.3708f, 11.5746f, 119.2609f),
+		FVector(5.6239f, 21.0835f, 117.6186f),
+	};
+	const int32 chainNum = ARRAY_COUNT(expected);
+	const float tolerance = 0.01f;
+
+	for (int pass = 0; pass < 2; ++pass) {
+		const bool bSIMD = (pass == 1);
+
+		FBenchAvatar avatar;
+		avatar.Build(chainNum * BenchChainLength, 8);
+		avatar.Run(120, 1, bSIMD);
+
+		for (int c = 0; c < chainNum; ++c) {
+			const int32 j = (c + 1) * BenchChainLength - 1;
+			const float error = (avatar.curTail[j] - expected[c]).Size();
+			TestTrue(FString::Printf(TEXT("%s tail %d error %f"), bSIMD ? TEXT("simd") : TEXT("scalar"), j, error), error < tolerance);
+		}
+	}
+	return true;
+}
+
+#endif
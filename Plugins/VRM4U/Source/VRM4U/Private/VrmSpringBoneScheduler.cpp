@@ -0,0 +1,95 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#include "VrmSpringBoneScheduler.h"
+#include "Engine/World.h"
+#include "Misc/ScopeLock.h"
+
+#include "AnimNode_VrmSpringBone.h"
+
+namespace {
+	FCriticalSection SchedulerMapLock;
+	TMap<UWorld*, TUniquePtr<FVrmSpringBoneScheduler>> SchedulerMap;
+
+	FDelegateHandle PostActorTickHandle;
+	FDelegateHandle WorldCleanupHandle;
+
+	int32 SchedulerSerial = 0;
+}
+
+FVrmSpringBoneScheduler *FVrmSpringBoneScheduler::Get(UWorld *World) {
+	if (World == nullptr) {
+		return nullptr;
+	}
+	FScopeLock lock(&SchedulerMapLock);
+
+	auto *p = SchedulerMap.Find(World);
+	if (p) {
+		return p->Get();
+	}
+	auto *s = SchedulerMap.Add(World, MakeUnique<FVrmSpringBoneScheduler>()).Get();
+	s->Serial = ++SchedulerSerial;
+	return s;
+}
+
+void FVrmSpringBoneScheduler::Register(const TSharedPtr<VRMSpring::VRMSpringManager, ESPMode::ThreadSafe> &Manager) {
+	FScopeLock lock(&ListLock);
+	for (const auto &m : ManagerList) {
+		if (m.HasSameObject(Manager.Get())) {
+			return;
+		}
+	}
+	ManagerList.Add(Manager);
+}
+
+void FVrmSpringBoneScheduler::Solve() {
+	TArray<TSharedPtr<VRMSpring::VRMSpringManager, ESPMode::ThreadSafe>> list;
+	{
+		FScopeLock lock(&ListLock);
+
+		for (int i = ManagerList.Num() - 1; i >= 0; --i) {
+			auto m = ManagerList[i].Pin();
+			if (m.IsValid() == false || VRMSpring::IsScheduled(*m) == false) {
+				ManagerList.RemoveAtSwap(i);
+				continue;
+			}
+			list.Add(m);
+		}
+	}
+	if (list.Num() == 0) {
+		return;
+	}
+	VRMSpring::SolveScheduled(list);
+}
+
+void FVrmSpringBoneScheduler::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds) {
+	FVrmSpringBoneScheduler *s = nullptr;
+	{
+		FScopeLock lock(&SchedulerMapLock);
+		auto *p = SchedulerMap.Find(World);
+		if (p) {
+			s = p->Get();
+		}
+	}
+	// anim evaluation of this frame is done
+	if (s) {
+		s->Solve();
+	}
+}
+
+void FVrmSpringBoneScheduler::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources) {
+	FScopeLock lock(&SchedulerMapLock);
+	SchedulerMap.Remove(World);
+}
+
+void FVrmSpringBoneScheduler::StartupModule() {
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&FVrmSpringBoneScheduler::OnWorldPostActorTick);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&FVrmSpringBoneScheduler::OnWorldCleanup);
+}
+
+void FVrmSpringBoneScheduler::ShutdownModule() {
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+
+	FScopeLock lock(&SchedulerMapLock);
+	SchedulerMap.Empty();
+}
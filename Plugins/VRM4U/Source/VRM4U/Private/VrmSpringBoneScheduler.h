@@ -0,0 +1,44 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+
+namespace VRMSpring {
+	class VRMSpringManager;
+}
+
+/**
+ * World level spring bone scheduler.
+ * Anim nodes capture their pose and register here. All chains of all avatars are solved
+ * in one ParallelFor after the world tick, and used by the next evaluation of each node.
+ * Plain C++ instead of UWorldSubsystem to keep UE4.19-4.21 support.
+ */
+class FVrmSpringBoneScheduler {
+public:
+	// any thread
+	static FVrmSpringBoneScheduler *Get(UWorld *World);
+
+	// any thread. a manager already in the list is not added again
+	void Register(const TSharedPtr<VRMSpring::VRMSpringManager, ESPMode::ThreadSafe> &Manager);
+
+	// unique per scheduler. a new one for the same world gets a new serial
+	int32 GetSerial() const { return Serial; }
+
+	static void StartupModule();
+	static void ShutdownModule();
+
+private:
+	void Solve();
+
+	static void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	static void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+	int32 Serial = 0;
+
+	FCriticalSection ListLock;
+	TArray<TWeakPtr<VRMSpring::VRMSpringManager, ESPMode::ThreadSafe>> ManagerList;
+};
@@ -0,0 +1,129 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Spring bone solver math. depends on Core only,
+ * shared by FAnimNode_VrmSpringBone and the benchmark.
+ */
+namespace VRMSpringSolver {
+	// joints of the same chain depth, solved together.
+	// SIMD results match the scalar path within 1e-4 relative (rsqrt refinement, operation order).
+	static const int32 SpringLaneNum = 4;
+
+	struct FSpringLane {
+		alignas(16) float curX[SpringLaneNum], curY[SpringLaneNum], curZ[SpringLaneNum];
+		alignas(16) float prevX[SpringLaneNum], prevY[SpringLaneNum], prevZ[SpringLaneNum];
+		alignas(16) float headX[SpringLaneNum], headY[SpringLaneNum], headZ[SpringLaneNum];
+		alignas(16) float axisX[SpringLaneNum], axisY[SpringLaneNum], axisZ[SpringLaneNum];
+		alignas(16) float length[SpringLaneNum];
+
+		// out
+		alignas(16) float nextX[SpringLaneNum], nextY[SpringLaneNum], nextZ[SpringLaneNum];
+
+		void SetCur(int i, const FVector &v) { curX[i] = v.X; curY[i] = v.Y; curZ[i] = v.Z; }
+		void SetPrev(int i, const FVector &v) { prevX[i] = v.X; prevY[i] = v.Y; prevZ[i] = v.Z; }
+		void SetHead(int i, const FVector &v) { headX[i] = v.X; headY[i] = v.Y; headZ[i] = v.Z; }
+		void SetAxis(int i, const FVector &v) { axisX[i] = v.X; axisY[i] = v.Y; axisZ[i] = v.Z; }
+		FVector GetNext(int i) const { return FVector(nextX[i], nextY[i], nextZ[i]); }
+	};
+
+	// verlet + length constraint. scalar reference
+	inline void SpringVerletScalar(FSpringLane &L, int num, float dragForce, float stiffnessForce, const FVector &external) {
+		for (int i = 0; i < num; ++i) {
+			const FVector cur(L.curX[i], L.curY[i], L.curZ[i]);
+			const FVector prev(L.prevX[i], L.prevY[i], L.prevZ[i]);
+			const FVector head(L.headX[i], L.headY[i], L.headZ[i]);
+			const FVector axis(L.axisX[i], L.axisY[i], L.axisZ[i]);
+
+			FVector next = cur + (cur - prev) * (1.0f - dragForce) + axis * stiffnessForce + external;
+			next = head + (next - head).GetSafeNormal() * L.length[i];
+
+			L.nextX[i] = next.X; L.nextY[i] = next.Y; L.nextZ[i] = next.Z;
+		}
+	}
+
+	// verlet + length constraint. 4 joints at once
+	inline void SpringVerletSIMD(FSpringLane &L, float dragForce, float stiffnessForce, const FVector &external) {
+		const VectorRegister drag = VectorSetFloat1(1.0f - dragForce);
+		const VectorRegister stiff = VectorSetFloat1(stiffnessForce);
+		const VectorRegister tolerance = VectorSetFloat1(SMALL_NUMBER);
+
+		const VectorRegister cx = VectorLoadAligned(L.curX);
+		const VectorRegister cy = VectorLoadAligned(L.curY);
+		const VectorRegister cz = VectorLoadAligned(L.curZ);
+
+		VectorRegister nx = VectorAdd(cx, VectorMultiply(VectorSubtract(cx, VectorLoadAligned(L.prevX)), drag));
+		VectorRegister ny = VectorAdd(cy, VectorMultiply(VectorSubtract(cy, VectorLoadAligned(L.prevY)), drag));
+		VectorRegister nz = VectorAdd(cz, VectorMultiply(VectorSubtract(cz, VectorLoadAligned(L.prevZ)), drag));
+
+		nx = VectorAdd(VectorMultiplyAdd(VectorLoadAligned(L.axisX), stiff, nx), VectorSetFloat1(external.X));
+		ny = VectorAdd(VectorMultiplyAdd(VectorLoadAligned(L.axisY), stiff, ny), VectorSetFloat1(external.Y));
+		nz = VectorAdd(VectorMultiplyAdd(VectorLoadAligned(L.axisZ), stiff, nz), VectorSetFloat1(external.Z));
+
+		const VectorRegister hx = VectorLoadAligned(L.headX);
+		const VectorRegister hy = VectorLoadAligned(L.headY);
+		const VectorRegister hz = VectorLoadAligned(L.headZ);
+
+		const VectorRegister dx = VectorSubtract(nx, hx);
+		const VectorRegister dy = VectorSubtract(ny, hy);
+		const VectorRegister dz = VectorSubtract(nz, hz);
+
+		const VectorRegister lenSq = VectorMultiplyAdd(dx, dx, VectorMultiplyAdd(dy, dy, VectorMultiply(dz, dz)));
+
+		// GetSafeNormal. zero length -> zero vector
+		VectorRegister scale = VectorMultiply(VectorReciprocalSqrtAccurate(lenSq), VectorLoadAligned(L.length));
+		scale = VectorSelect(VectorCompareGT(lenSq, tolerance), scale, VectorZero());
+
+		VectorStoreAligned(VectorMultiplyAdd(dx, scale, hx), L.nextX);
+		VectorStoreAligned(VectorMultiplyAdd(dy, scale, hy), L.nextY);
+		VectorStoreAligned(VectorMultiplyAdd(dz, scale, hz), L.nextZ);
+	}
+
+	// FQuat::FindBetween for normalized input.
+	// lanes with opposite/zero vectors are left to the scalar path (return false)
+	struct FSpringRotLane {
+		alignas(16) float aX[SpringLaneNum], aY[SpringLaneNum], aZ[SpringLaneNum];
+		alignas(16) float bX[SpringLaneNum], bY[SpringLaneNum], bZ[SpringLaneNum];
+		alignas(16) float qX[SpringLaneNum], qY[SpringLaneNum], qZ[SpringLaneNum], qW[SpringLaneNum];
+	};
+
+	inline int SpringFindBetweenSIMD(FSpringRotLane &R) {
+		const VectorRegister ax = VectorLoadAligned(R.aX);
+		const VectorRegister ay = VectorLoadAligned(R.aY);
+		const VectorRegister az = VectorLoadAligned(R.aZ);
+		const VectorRegister bx = VectorLoadAligned(R.bX);
+		const VectorRegister by = VectorLoadAligned(R.bY);
+		const VectorRegister bz = VectorLoadAligned(R.bZ);
+
+		const VectorRegister w = VectorAdd(VectorOne(), VectorMultiplyAdd(ax, bx, VectorMultiplyAdd(ay, by, VectorMultiply(az, bz))));
+		const VectorRegister x = VectorSubtract(VectorMultiply(ay, bz), VectorMultiply(az, by));
+		const VectorRegister y = VectorSubtract(VectorMultiply(az, bx), VectorMultiply(ax, bz));
+		const VectorRegister z = VectorSubtract(VectorMultiply(ax, by), VectorMultiply(ay, bx));
+
+		const VectorRegister sizeSq = VectorMultiplyAdd(x, x, VectorMultiplyAdd(y, y, VectorMultiplyAdd(z, z, VectorMultiply(w, w))));
+		const VectorRegister inv = VectorReciprocalSqrtAccurate(sizeSq);
+
+		VectorStoreAligned(VectorMultiply(x, inv), R.qX);
+		VectorStoreAligned(VectorMultiply(y, inv), R.qY);
+		VectorStoreAligned(VectorMultiply(z, inv), R.qZ);
+		VectorStoreAligned(VectorMultiply(w, inv), R.qW);
+
+		// valid lane mask
+		return VectorMaskBits(VectorCompareGE(w, VectorSetFloat1(1.e-6f)));
+	}
+
+	// push the tail out of a sphere and keep the bone length
+	inline FVector SpringCollideSphere(const FVector &head, float length, const FVector &nextTail, const FVector &sphereCenter, float radius) {
+		if ((sphereCenter - nextTail).SizeSquared() > radius * radius) {
+			return nextTail;
+		}
+		// ヒット。Colliderの半径方向に押し出す
+		auto normal = (nextTail - sphereCenter).GetSafeNormal();
+		auto posFromCollider = sphereCenter + normal * (radius);
+		// 長さをboneLengthに強制
+		return head + (posFromCollider - head).GetSafeNormal() * length;
+	}
+}
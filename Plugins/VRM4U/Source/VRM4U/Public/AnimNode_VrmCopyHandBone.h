@@ -12,8 +12,21 @@
 #include "AnimNode_VrmCopyHandBone.generated.h"
 
 class USkeletalMeshComponent;
+class USkeletalMesh;
 class UVrmMetaObject;
 
+// hand bone resolved from the tables. sorted by compact index
+struct FVrmCopyHandBoneCache {
+	int32 dstIndex = INDEX_NONE;		// skeleton bone index
+	FCompactPoseBoneIndex compactIndex = FCompactPoseBoneIndex(INDEX_NONE);
+	int32 parentInCache = INDEX_NONE;
+
+	// per source mesh. left, right
+	int32 srcIndex[2] = { INDEX_NONE, INDEX_NONE };
+	int32 srcParentIndex[2] = { INDEX_NONE, INDEX_NONE };
+	FQuat q[2] = { FQuat::Identity, FQuat::Identity };	// reference pose delta
+};
+
 /**
 *	Simple controller that replaces or adds to the translation/rotation of a single bone.
 */
@@ -46,4 +59,13 @@ private:
 	// FAnimNode_SkeletalControlBase interface
 	virtual void InitializeBoneReferences(const FBoneContainer& RequiredBones) override;
 	// End of FAnimNode_SkeletalControlBase interface
+
+	// rebuilt when a mesh, the skeleton or the required bones change
+	void BuildCache(const USkeleton *Skeleton, const FBoneContainer& RequiredBones);
+
+	TArray<FVrmCopyHandBoneCache> BoneCache;
+	bool bCacheDirty = true;
+	const UVrmMetaObject *CacheMeta = nullptr;
+	const USkeleton *CacheSkeleton = nullptr;
+	const USkeletalMesh *CacheSrcMesh[2] = { nullptr, nullptr };
 };
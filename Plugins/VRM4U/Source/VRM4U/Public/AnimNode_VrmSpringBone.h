@@ -7,6 +7,7 @@
 #include "BoneContainer.h"
 #include "BonePose.h"
 #include "BoneControllers/AnimNode_ModifyBone.h"
+#include "Engine/EngineTypes.h"
 #include "Misc/EngineVersionComparison.h"
 
 #include "AnimNode_VrmSpringBone.generated.h"
@@ -16,9 +17,34 @@ class UVrmMetaObject;
 
 namespace VRMSpring {
 	class VRMSpringManager;
+
+	// FVrmSpringBoneScheduler
+	bool IsScheduled(const VRMSpringManager &manager);
+	void SolveScheduled(const TArray<TSharedPtr<VRMSpringManager, ESPMode::ThreadSafe>> &managerList);
 }
 
 
+USTRUCT(BlueprintType)
+struct VRM4U_API FVrmSpringBoneLODSetting
+{
+	GENERATED_BODY()
+
+	// used while the mesh is smaller than this on screen
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD)
+	float ScreenSize = 0.f;
+
+	// simulate every N frames
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD, meta = (ClampMin = "1"))
+	int UpdateRateDivisor = 1;
+
+	// joints deeper than this keep the animated pose. 0 = all
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD, meta = (ClampMin = "0"))
+	int MaxChainDepth = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD)
+	bool bSkipCollision = false;
+};
+
 /**
 *	Simple controller that replaces or adds to the translation/rotation of a single bone.
 */
@@ -45,6 +71,46 @@ struct VRM4U_API FAnimNode_VrmSpringBone : public FAnimNode_SkeletalControlBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta = (PinHiddenByDefault))
 	int loopc = 1;
 
+	// simulate at FixedTimestepRate instead of dividing the frame by loopc. output is interpolated between the last two steps
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta = (PinHiddenByDefault))
+	bool bFixedTimestep = false;
+
+	// Hz
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta = (PinHiddenByDefault, EditCondition = "bFixedTimestep", ClampMin = "1"))
+	float FixedTimestepRate = 60.f;
+
+	// max simulation steps per frame. time over this budget is dropped
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta = (PinHiddenByDefault, EditCondition = "bFixedTimestep", ClampMin = "1"))
+	int MaxSubstep = 4;
+
+	// chains at rest stop simulating until the root or a collider moves
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sleep)
+	bool bChainSleep = false;
+
+	// frames below the thresholds before a chain sleeps
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sleep, meta = (EditCondition = "bChainSleep", ClampMin = "1"))
+	int SleepFrameCount = 30;
+
+	// tail and root speed. cm/s
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sleep, meta = (EditCondition = "bChainSleep", ClampMin = "0"))
+	float SleepVelocity = 0.5f;
+
+	// root rotation per frame. degree
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sleep, meta = (EditCondition = "bChainSleep", ClampMin = "0"))
+	float SleepRootRotation = 0.05f;
+
+	// from high to low detail. ScreenSize should decrease
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD)
+	TArray<FVrmSpringBoneLODSetting> LODSetting;
+
+	// stop simulation while the mesh is not rendered. restarts from the current pose
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD)
+	bool bFreezeOffscreen = false;
+
+	// solve time per frame of this avatar. over budget moves to a lower LOD. 0 = no budget
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = LOD, meta = (ClampMin = "0"))
+	float BudgetMicroSeconds = 0.f;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta = (PinHiddenByDefault))
 	bool bIgnorePhysicsResetOnTeleport = true;
 
@@ -54,10 +120,32 @@ struct VRM4U_API FAnimNode_VrmSpringBone : public FAnimNode_SkeletalControlBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta=(PinHiddenByDefault))
 	bool bIgnoreVRMCollision = false;
 
-	TSharedPtr<VRMSpring::VRMSpringManager> SpringManager;
+	// batch physics collision of all joints and run it asynchronously. results are applied on a later frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta=(PinHiddenByDefault))
+	bool bAsyncPhysicsCollision = false;
+
+	// object types for async physics collision. FVRMSpringMeta::physicsCollisionChannelMask overrides it per spring
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Skeleton, meta=(PinHiddenByDefault, Bitmask, BitmaskEnum = "ECollisionChannel"))
+	int32 PhysicsCollisionChannelMask = ECC_TO_BITFIELD(ECC_WorldStatic) | ECC_TO_BITFIELD(ECC_WorldDynamic);
+
+	TSharedPtr<VRMSpring::VRMSpringManager, ESPMode::ThreadSafe> SpringManager;
 
 	float CurrentDeltaTime = 0.f;
 
+	// LOD state
+	float LODScreenSize = 1.f;
+	bool bLODVisible = true;
+	bool bLODFrozen = false;
+	bool bLODSkipSolve = false;
+	int LODIndex = INDEX_NONE;
+	int LODBudgetBias = 0;
+	int LODBudgetCooldown = 0;
+	int LODFrameCount = 0;
+	float LODSkippedTime = 0.f;
+	float LODCostMicroSeconds = 0.f;
+	const FVrmSpringBoneLODSetting *GetLODSetting() const;
+	void UpdateLOD();
+
 	bool bCallByAnimInstance = false;
 	TArray<FBoneTransform> BoneTransformsSpring;
 	bool IsSprintInit() const;
@@ -66,6 +154,8 @@ struct VRM4U_API FAnimNode_VrmSpringBone : public FAnimNode_SkeletalControlBase
 
 	// FAnimNode_Base interface
 	virtual void GatherDebugData(FNodeDebugData& DebugData) override;
+	virtual bool HasPreUpdate() const override { return true; }
+	virtual void PreUpdate(const UAnimInstance* InAnimInstance) override;
 	// End of FAnimNode_Base interface
 
 	// FAnimNode_SkeletalControlBase interface
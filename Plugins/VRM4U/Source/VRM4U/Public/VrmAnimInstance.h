@@ -11,6 +11,8 @@
 
 class UVrmMetaObject;
 class USkeleton;
+struct FAnimNode_TwoBoneIK;
+struct FAnimNode_SplineIK;
 
 UENUM(BlueprintType)
 enum class EVrmMorphGroupType : uint8
@@ -35,6 +37,43 @@ enum class EVrmMorphGroupType : uint8
 	Num				UMETA(Hidden)
 };
 
+// blend shape groups compiled to morph targets. rebuilt when the meta changes
+struct VRM4U_API FVrmExpressionTable {
+	struct FBind {
+		int32 morphIndex = 0;
+		float weight = 0.f;		// bind weight, 0-1
+	};
+	TArray<FName> morphName;					// unique morph targets
+	TArray<FBind> bind[(int)EVrmMorphGroupType::Num];	// per group. binds to the same morph merged
+	const UVrmMetaObject *meta = nullptr;
+
+	void Build(const UVrmMetaObject *InMeta);
+
+	// per morph target sum of group weight * bind weight
+	void Evaluate(const float *groupWeight, TArray<float> &morphWeight) const;
+};
+
+// timestamped expression frames. one producer thread, one consumer thread, no lock
+struct VRM4U_API FVrmExpressionStream {
+	struct FFrame {
+		double time = 0;				// FPlatformTime::Seconds
+		float weight[(int)EVrmMorphGroupType::Num];
+	};
+	// one slot is kept empty to tell full from empty
+	static const int32 FrameNum = 64;
+
+	// producer. false when full, the frame is dropped
+	bool Push(double time, const float *weight, int32 num);
+
+	// consumer. interpolated at time. false until the first frame.
+	// outSampleTime is time clamped to the frames, it stops moving when no new frame arrives
+	bool Sample(double time, float *outWeight, double *outSampleTime = nullptr);
+
+private:
+	FFrame frame[FrameNum];
+	volatile int32 writeIndex = 0;
+	volatile int32 readIndex = 0;		// the oldest frame still needed by the consumer
+};
 
 USTRUCT()
 struct VRM4U_API FVrmAnimInstanceProxy : public FAnimInstanceProxy {
@@ -59,6 +98,28 @@ public:
 #else
 	virtual void UpdateAnimationNode(const FAnimationUpdateContext& InContext);
 #endif
+
+	// tracking. captured on the game thread. hand L, hand R, head in world space
+	const UVrmMetaObject *TrackingMeta = nullptr;
+	FTransform TrackingTarget[3];
+	FVector TrackingJointTarget[2] = { FVector::ZeroVector, FVector::ZeroVector };
+
+	// IK nodes. rebuilt when the mesh or meta changes
+	TSharedPtr<FAnimNode_TwoBoneIK> HandIK[2];
+	TSharedPtr<FAnimNode_SplineIK> HeadIK;
+	const UVrmMetaObject *IKMeta = nullptr;
+	const USkeletalMesh *IKMesh = nullptr;
+	TArray<FBoneIndexType> IKCompactBoneIndices;		// required bones the IK nodes cached
+
+	// expression stream. sampled on the worker thread, pushed to the component after evaluation.
+	// the table is a copy made on the game thread, the setters may rebuild the one of the instance
+	FVrmExpressionTable ExpressionTable;
+	float ExpressionStreamDelay = 0.f;
+	TArray<float> StreamMorphWeight;
+	double StreamSampleTime = -1.0;
+	bool bStreamMorphWeight = false;		// a new sample to push
+
+	void BuildIK(const UVrmMetaObject *meta, const USkeletalMesh *mesh);
 };
 
 /**
@@ -98,8 +159,30 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tracking)
 		USceneComponent *ComponentHandJointTargetRight;
 
+	// frames are sampled this much in the past so that there is a frame on both sides
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Tracking)
+	float ExpressionStreamDelay = 0.f;
+
+	// any thread, one producer. weights indexed by EVrmMorphGroupType. time from FPlatformTime::Seconds.
+	// while new frames arrive they override SetMorphTargetVRM for the morphs they bind.
+	// the last frame is pushed once, the setters win after that
+	bool PushExpressionFrame(double Time, const float *Weights, int32 Num);
+
 protected:
 	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+
+	FVrmAnimInstanceProxy *myProxy = nullptr;
+
+	FVrmExpressionTable ExpressionTable;
+	TArray<float> ExpressionWeight;		// per group
+	TArray<float> MorphWeight;			// per ExpressionTable.morphName
+
+	FVrmExpressionStream ExpressionStream;
+
+	bool UpdateExpressionTable();
+	void PushMorphWeight();
+
+	friend struct FVrmAnimInstanceProxy;
 public:
 	virtual void NativeInitializeAnimation()override;
 	// Native update override point. It is usually a good idea to simply gather data in this step and 
@@ -118,6 +201,10 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Animation")
 	void SetMorphTargetVRM(EVrmMorphGroupType type, float Value);
 
+	// all groups at once. indexed by EVrmMorphGroupType. missing entries are 0
+	UFUNCTION(BlueprintCallable, Category="Animation")
+	void SetMorphTargetVRMBatch(const TArray<float> &Values);
+
 	
 	UFUNCTION(BlueprintCallable, Category = "Animation")
 	void SetVrmData(USkeletalMeshComponent *baseSkeletalMesh, UVrmMetaObject *meta);
@@ -10,8 +10,51 @@
 #include "VrmAnimInstanceCopy.generated.h"
 
 class UVrmAssetListObject;
+class UVrmMetaObject;
+class UVrmPoseSnapshot;
+class UVrmRetargetBroadcaster;
 struct FAnimNode_VrmSpringBone;
 
+// humanoid pose relative to the reference pose. independent of the mesh
+struct VRM4U_API FVrmHumanoidPose {
+	TArray<FQuat> rotation;			// per humanoid bone. from the reference rotation, parent bone space
+	TArray<uint8> bValid;
+	FVector hipTranslation = FVector::ZeroVector;	// from the reference location, per hip height
+
+	void Init(int32 num);
+};
+
+// humanoid bones of one mesh. rebuilt when the mesh or meta changes
+struct VRM4U_API FVrmHumanoidMap {
+	struct FBone {
+		int32 humanoidIndex = INDEX_NONE;
+		int32 boneIndex = INDEX_NONE;		// mesh bone index
+		int32 parentIndex = INDEX_NONE;
+		FCompactPoseBoneIndex compactIndex = FCompactPoseBoneIndex(INDEX_NONE);
+		FQuat refRotationInv = FQuat::Identity;
+		FTransform ref = FTransform::Identity;
+	};
+	TArray<FBone> bone;
+	float hipLocalHeight = 1.f;		// source side. local Z of the hips
+	float hipHeight = 1.f;			// destination side. Z of the hips from the root
+
+	const UVrmMetaObject *meta = nullptr;
+	const USkeletalMesh *mesh = nullptr;
+	TArray<FBoneIndexType> compactBoneIndices;		// required bones compactIndex was resolved with
+
+	static int32 GetHumanoidBoneNum();
+
+	bool IsValid(const UVrmMetaObject *InMeta, const USkeletalMesh *InMesh) const;
+	void Build(const UVrmMetaObject *InMeta, const USkeletalMesh *InMesh);
+	void ResolveCompactIndex(const FBoneContainer &RequiredBones);
+	void Reset();
+
+	// source. pose is parent bone space when bLocal, else component space
+	void Decode(const TArray<FTransform> &pose, bool bLocal, FVrmHumanoidPose &out) const;
+	// destination
+	void Apply(const FVrmHumanoidPose &in, FCompactPose &pose) const;
+};
+
 USTRUCT()
 struct VRM4U_API FVrmAnimInstanceCopyProxy : public FAnimInstanceProxy {
 
@@ -21,6 +64,11 @@ public:
 	float CurrentDeltaTime = 0.f;
 	bool bIgnoreVRMSwingBone = false;
 	TSharedPtr<FAnimNode_VrmSpringBone> SpringBoneNode;
+	FVrmHumanoidMap SrcMap;
+	FVrmHumanoidMap DstMap;
+	FVrmHumanoidPose HumanoidPose;
+	const UVrmPoseSnapshot *SrcPoseSnapshot = nullptr;
+	const UVrmRetargetBroadcaster *SrcBroadcaster = nullptr;
 
 	FVrmAnimInstanceCopyProxy();
 
@@ -53,6 +101,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
 	UVrmAssetListObject *DstVrmAssetList;
 
+	// read the source pose from a snapshot published after its evaluation. source and copies can evaluate in parallel
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	bool bUseSourcePoseSnapshot = true;
+
+	// decode the source once for all copies of it. overrides bUseSourcePoseSnapshot
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	bool bUseRetargetBroadcaster = false;
+
+	UPROPERTY(Transient)
+	UVrmPoseSnapshot *SrcPoseSnapshot = nullptr;
+
+	UPROPERTY(Transient)
+	UVrmRetargetBroadcaster *SrcBroadcaster = nullptr;
+
 protected:
 	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 
@@ -37,6 +37,10 @@ struct VRM4U_API FVRMSpringMeta{
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
 	TArray<int> ColliderIndexArray;
+
+	// object type bitmask for async physics collision. -1 uses the anim node setting, 0 disables
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	int32 physicsCollisionChannelMask = -1;
 };
 
 USTRUCT(Blueprintable, BlueprintType)
@@ -63,6 +67,33 @@ struct VRM4U_API FVRMColliderMeta {
 	TArray<FVRMSpringColliderData> collider;
 };
 
+// spring bone chains resolved against the skeletal mesh. built at import
+USTRUCT(Blueprintable, BlueprintType)
+struct VRM4U_API FVRMSpringBake {
+	GENERATED_BODY()
+
+	// per spring. range in chain
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<int> springChainStart;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<int> springChainNum;
+
+	// per chain. range in joint
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<int> chainJointStart;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<int> chainJointNum;
+
+	// per joint. root to tip
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<FName> jointBoneName;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<int> jointBoneIndex;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<FVector> jointBoneAxis;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	TArray<float> jointLength;
+};
 
 // BlendShape
 USTRUCT(Blueprintable, BlueprintType)
@@ -123,8 +154,22 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
 	TArray<FVRMColliderMeta> VRMColliderMeta;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
+	FVRMSpringBake VRMSpringBake;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Rendering)
 	class USkeletalMesh *SkeletalMesh;
 
-	
+	// bumped on every bake and edit. the spring bone node rebuilds its cached setting when it changes
+	int32 SpringBakeVersion = 0;
+
+	// rebuild VRMSpringBake from VRMSpringMeta
+	void BakeSpringBone(const struct FReferenceSkeleton &RefSkeleton);
+	static void BakeSpringBone(const struct FReferenceSkeleton &RefSkeleton, const TArray<FVRMSpringMeta> &SpringMeta, FVRMSpringBake &Bake);
+
+	bool IsSpringBoneBaked() const;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 };
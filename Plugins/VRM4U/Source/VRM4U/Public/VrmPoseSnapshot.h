@@ -0,0 +1,44 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+
+#include "VrmPoseSnapshot.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * Local space pose of a source component, published on the game thread when its bone transforms are finalized.
+ * Double buffered. anim worker threads read the front buffer without a lock,
+ * so a source and its copies can evaluate in parallel. copies then see the last published pose.
+ */
+UCLASS()
+class VRM4U_API UVrmPoseSnapshot : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// game thread. one snapshot per source component
+	static UVrmPoseSnapshot *Get(USkeletalMeshComponent *Source);
+
+	// any thread. indexed by mesh bone. empty until the first publish
+	const TArray<FTransform> &GetLocalPose() const {
+		return Buffer[Front];
+	}
+
+	USkeletalMeshComponent *GetSource() const {
+		return Source.Get();
+	}
+
+private:
+	UFUNCTION()
+	void Publish();
+
+	TWeakObjectPtr<USkeletalMeshComponent> Source;
+
+	// the back buffer is written one frame after it was the front. readers finish within a frame
+	TArray<FTransform> Buffer[2];
+	volatile int32 Front = 0;
+};
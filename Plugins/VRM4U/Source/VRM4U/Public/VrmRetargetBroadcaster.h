@@ -0,0 +1,45 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/NoExportTypes.h"
+#include "VrmAnimInstanceCopy.h"
+
+#include "VrmRetargetBroadcaster.generated.h"
+
+class USkeletalMeshComponent;
+class UVrmMetaObject;
+
+/**
+ * Humanoid pose of a source component, decoded once per frame on the game thread when its bone transforms are finalized.
+ * Every copy of the source applies the same pose with its own FVrmHumanoidMap, in its own anim evaluation.
+ * Double buffered like UVrmPoseSnapshot.
+ */
+UCLASS()
+class VRM4U_API UVrmRetargetBroadcaster : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// game thread. one broadcaster per source component
+	static UVrmRetargetBroadcaster *Get(USkeletalMeshComponent *Source, const UVrmMetaObject *SourceMeta);
+
+	// any thread. empty until the first publish
+	const FVrmHumanoidPose &GetHumanoidPose() const {
+		return Buffer[Front];
+	}
+
+private:
+	UFUNCTION()
+	void Publish();
+
+	TWeakObjectPtr<USkeletalMeshComponent> Source;
+
+	TWeakObjectPtr<const UVrmMetaObject> SourceMeta;
+
+	FVrmHumanoidMap SrcMap;
+
+	FVrmHumanoidPose Buffer[2];
+	volatile int32 Front = 0;
+};
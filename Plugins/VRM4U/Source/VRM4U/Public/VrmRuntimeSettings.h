@@ -43,5 +43,13 @@ class VRM4U_API UVrmRuntimeSettings : public UObject
 		))
 	TArray<FString> extList;
 
+	// SpringBone. solve joints with SIMD. off = scalar reference path
+	UPROPERTY(config, EditAnywhere, Category = SpringBone)
+	bool bSpringBoneSIMD = true;
+
+	// SpringBone. solve all avatars together once per frame (one frame latency). off = solve inline in each anim node
+	UPROPERTY(config, EditAnywhere, Category = SpringBone)
+	bool bSpringBoneScheduler = false;
+
 
 };
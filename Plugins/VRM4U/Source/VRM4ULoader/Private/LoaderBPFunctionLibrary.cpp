@@ -11,6 +11,8 @@
 #include "VrmLicenseObject.h"
 
 #include "VrmConvert.h"
+#include "VrmConvertMeshData.h"
+#include "VrmMappedIOSystem.h"
 
 #include "Components/SkeletalMeshComponent.h"
 #include "Rendering/SkeletalMeshLODRenderData.h"
@@ -47,39 +49,12 @@
 
 //#include "Windows/WindowsSystemIncludes.h"
 
-#if PLATFORM_WINDOWS
-#include "Windows/AllowWindowsPlatformTypes.h"
-#include <windows.h>
-#include "Windows/HideWindowsPlatformTypes.h"
-#endif
-
 // tem
 namespace {
 	UPackage *s_vrm_package = nullptr;
 	FString baseFileName;
 }
 
-namespace {
-	class RenderControl {
-		bool tmp = false;
-	public:
-		RenderControl() {
-			tmp = GUseThreadedRendering;
-
-			if (tmp) {
-				StopRenderingThread();
-				GUseThreadedRendering = false;
-			}
-		}
-		~RenderControl() {
-			if (tmp) {
-				GUseThreadedRendering = true;
-				StartRenderingThread();
-			}
-		}
-	};
-}
-
 static bool saveObject(UObject *u, bool bSave) {
 #if WITH_EDITOR
 	if (u == nullptr) return false;
@@ -210,57 +185,19 @@ void ULoaderBPFunctionLibrary::SetImportMode(bool bIm, class UPackage *p) {
 	s_vrm_package = p;
 }
 
-namespace {
-#if PLATFORM_WINDOWS
-	std::string utf_16_to_shift_jis(const std::wstring& str) {
-		static_assert(sizeof(wchar_t) == 2, "this function is windows only");
-		const int len = ::WideCharToMultiByte(932/*CP_ACP*/, 0, str.c_str(), -1, nullptr, 0, nullptr, nullptr);
-		std::string re(len * 2, '\0');
-		if (!::WideCharToMultiByte(CP_ACP, 0, str.c_str(), -1, &re[0], len, nullptr, nullptr)) {
-			const auto ec = ::GetLastError();
-			switch (ec)
-			{
-			case ERROR_INSUFFICIENT_BUFFER:
-				//throw std::runtime_error("in function utf_16_to_shift_jis, WideCharToMultiByte fail. cause: ERROR_INSUFFICIENT_BUFFER"); break;
-			case ERROR_INVALID_FLAGS:
-				//throw std::runtime_error("in function utf_16_to_shift_jis, WideCharToMultiByte fail. cause: ERROR_INVALID_FLAGS"); break;
-			case ERROR_INVALID_PARAMETER:
-				//throw std::runtime_error("in function utf_16_to_shift_jis, WideCharToMultiByte fail. cause: ERROR_INVALID_PARAMETER"); break;
-			default:
-				//throw std::runtime_error("in function utf_16_to_shift_jis, WideCharToMultiByte fail. cause: unknown(" + std::to_string(ec) + ')'); break;
-				break;
-			}
-		}
-		const std::size_t real_len = std::strlen(re.c_str());
-		re.resize(real_len);
-		re.shrink_to_fit();
-		return re;
+UVrmLicenseObject* ULoaderBPFunctionLibrary::GetVRMMeta(FString filepath) {
+	// vrm/glb. the json chunk is enough
+	if (UVrmLicenseObject *lic = VRMConverter::GetVRMMetaFromGLB(filepath)) {
+		return lic;
 	}
-#endif
-}
 
-UVrmLicenseObject* ULoaderBPFunctionLibrary::GetVRMMeta(FString filepath) {
-	std::string file;
-#if PLATFORM_WINDOWS
-	file = utf_16_to_shift_jis(*filepath);
-#else
-	file = TCHAR_TO_UTF8(*filepath);
-#endif
 	const aiScene *mScenePtr = nullptr;
 	Assimp::Importer mImporter;
 
 	{
-		TArray<uint8> Res;
-		if (FFileHelper::LoadFileToArray(Res, *filepath)) {
-		}
-		const FString ext = FPaths::GetExtension(filepath);
-		std::string e = utf_16_to_shift_jis(*ext);
-
-		mScenePtr = mImporter.ReadFileFromMemory(Res.GetData(), Res.Num(),
-			aiProcess_Triangulate | aiProcess_MakeLeftHanded | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_OptimizeMeshes,
-			e.c_str());
-
-		//UE_LOG(LogTemp, Log, TEXT("VRM:(%3.3lf secs) ReadFileFromMemory"), FPlatformTime::Seconds() - StartTime);
+		// meta and textures only. no mesh process
+		mImporter.SetIOHandler(new VRMMappedIOSystem());
+		mScenePtr = mImporter.ReadFile(TCHAR_TO_UTF8(*filepath), 0);
 	}
 	if (mScenePtr == nullptr) {
 		return nullptr;
@@ -364,44 +301,22 @@ bool ULoaderBPFunctionLibrary::VRMSetLoadMaterialType(EVRMImportMaterialType typ
 	return true;
 }
 
-bool ULoaderBPFunctionLibrary::LoadVRMFile(const UVrmAssetListObject *InVrmAsset, UVrmAssetListObject *&OutVrmAsset, FString filepath) {
-
-	RenderControl _dummy_control;
-
-	if (InVrmAsset == nullptr) {
-		return false;
-	}
-
-	Assimp::Importer mImporter;
-	const aiScene* mScenePtr = nullptr;
+FVrmParseData::FVrmParseData(const FString &InFilepath, const VRMConverter::VRMParseOption &InOption)
+	: filepath(InFilepath)
+	, option(InOption)
+{
+	bVRMModel = FPaths::GetExtension(filepath).Equals(TEXT("vrm"), ESearchCase::CaseSensitive);
+	option.bVRMModel = bVRMModel;
+}
 
-	if (filepath.IsEmpty())
-	{
-	}
-	//filepath.esc
-	//setlocale(LC_ALL, "");
-	//_tsetlocale(LC_ALL, _T(""));
-	//_wsetlocale(LC_ALL, _T(""));
-	std::string file;
-	//TChar a;
-	//switch (type)
-	//{
-	//case EPathType::Absolute:
-	//file = TCHAR_TO_UTF8(filepath.GetCharArray().GetData());
-	//file = TCHAR_TO_ANSI( *filepath );
-	//file = TCHAR_TO_UTF8(*filepath.ReplaceCharWithEscapedChar());
-	//file = TCHAR_TO_UTF8(*filepath);
-#if PLATFORM_WINDOWS
-	file = utf_16_to_shift_jis(*filepath);
-#else
-	file = TCHAR_TO_UTF8(*filepath);
-#endif
+FVrmParseData::~FVrmParseData() {
+}
 
-	//	break;
-	//case EPathType::Relative:
-	//	file = TCHAR_TO_UTF8(*FPaths::Combine(FPaths::ProjectContentDir(), filepath));
-	//	break;
-	//}
+bool FVrmParseData::Parse() {
+	struct FDone {
+		FThreadSafeBool &b;
+		~FDone() { b = true; }
+	} done{ bDone };
 
 	double StartTime = FPlatformTime::Seconds();
 	auto LogAndUpdate = [&](FString logname) {
@@ -409,114 +324,197 @@ bool ULoaderBPFunctionLibrary::LoadVRMFile(const UVrmAssetListObject *InVrmAsset
 		StartTime = FPlatformTime::Seconds();
 	};
 
-	VRMConverter::Options::Get().SetVRMModel(true);
+	importer = MakeUnique<Assimp::Importer>();
 	{
-		TArray<uint8> Res;
-		if (FFileHelper::LoadFileToArray(Res, *filepath)) {
+		// assimp reads straight from the mapped file. no copy of the whole file, one parse
+		importer->SetIOHandler(new VRMMappedIOSystem());
+		mScenePtr = importer->ReadFile(TCHAR_TO_UTF8(*filepath), option.AssimpProcessFlags);
+		if (mScenePtr == nullptr) {
+			UE_LOG(LogTemp, Warning, TEXT("VRM4U: %s"), UTF8_TO_TCHAR(importer->GetErrorString()));
 		}
-		const FString ext = FPaths::GetExtension(filepath);
-		std::string e = utf_16_to_shift_jis(*ext);
+		LogAndUpdate(TEXT("ReadFile"));
+	}
+	if (mScenePtr == nullptr || bCancel) {
+		return false;
+	}
 
-		if (e.compare("vrm") == 0) {
-			VRMConverter::Options::Get().SetVRMModel(true);
-		} else {
-			VRMConverter::Options::Get().SetVRMModel(false);
+	// pure data. no UObject
+	bBoneName = VRMConverter::NormalizeBoneName(mScenePtr);
+	LogAndUpdate(TEXT("NormalizeBoneName"));
+	if (bCancel) {
+		return false;
+	}
+	// vertex, weight and morph buffers. the game thread only makes the UObjects
+	meshData = VRMConverter::BuildMeshData(mScenePtr, option);
+	LogAndUpdate(TEXT("BuildMeshData"));
+	if (bCancel) {
+		return false;
+	}
+	if (option.bMorphTarget) {
+		VRMConverter::BuildMorphData(mScenePtr, option, *meshData);
+		LogAndUpdate(TEXT("BuildMorphData"));
+		if (bCancel) {
+			return false;
 		}
+	}
+	VRMConverter::DecodeTextures(mScenePtr, decodedTexture);
+	LogAndUpdate(TEXT("DecodeTextures"));
 
-		mScenePtr = mImporter.ReadFileFromMemory(Res.GetData(), Res.Num(),
-			aiProcess_Triangulate | aiProcess_MakeLeftHanded | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_OptimizeMeshes,
-			e.c_str());
-		if (mScenePtr == nullptr) {
-			mScenePtr = mImporter.ReadFile(file, aiProcess_Triangulate | aiProcess_MakeLeftHanded | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_OptimizeMeshes);
-		}
+	return true;
+}
 
-		UE_LOG(LogTemp, Log, TEXT("VRM:(%3.3lf secs) ReadFileFromMemory"), FPlatformTime::Seconds() - StartTime);
-		StartTime = FPlatformTime::Seconds();
+static VRMConverter::VRMParseOption GetParseOption(const UVrmAssetListObject *InAsset) {
+	VRMConverter::VRMParseOption o = VRMConverter::Options::Get().GetParseOption();
+	if (InAsset && InAsset->bSkipMorphTarget) {
+		o.bMorphTarget = false;
 	}
-//	mScenePtr = mImporter.ReadFile(file, aiProcess_Triangulate | aiProcess_MakeLeftHanded | aiProcess_CalcTangentSpace | aiProcess_GenSmoothNormals | aiProcess_OptimizeMeshes);
+	return o;
+}
 
-	UpdateProgress(20);
-	if (mScenePtr == nullptr)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("VRM4U: read failure.\n"));
+FVrmLoadTask::FVrmLoadTask(const UVrmAssetListObject *InAsset, const FString &InFilepath)
+	: ParseData(MakeShareable(new FVrmParseData(InFilepath, GetParseOption(InAsset))))
+	, InVrmAsset(InAsset)
+{
+	check(IsInGameThread());
+	// the worker thread decodes textures with it
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+}
+
+FVrmLoadTask::~FVrmLoadTask() {
+}
+
+void FVrmLoadTask::Cancel() {
+	ParseData->bCancel = true;
+	bFinished = true;
+	bSuccess = false;
+}
+
+float FVrmLoadTask::GetProgress() const {
+	const float parse = 0.3f;
+	if (ParseData->bDone == false) {
+		return 0.f;
+	}
+	const int32 num = FinalizeStepNum;
+	return parse + (1.f - parse) * FMath::Min(step, num) / (float)num;
+}
+
+void FVrmLoadTask::AddReferencedObjects(FReferenceCollector& Collector) {
+	Collector.AddReferencedObject(InVrmAsset);
+	Collector.AddReferencedObject(out);
+}
+
+bool FVrmLoadTask::FinalizeStep() {
+	check(IsInGameThread());
+	if (bFinished) {
 		return false;
 	}
+	auto finish = [&](bool b) {
+		bFinished = true;
+		bSuccess = b;
+		return false;
+	};
 
+	auto &data = *ParseData;
+	const aiScene *mScenePtr = data.mScenePtr;
+	if (data.bCancel || data.bDone == false) {
+		return finish(false);
+	}
+	if (mScenePtr == nullptr || InVrmAsset == nullptr) {
+		UE_LOG(LogTemp, Warning, TEXT("VRM4U: read failure.\n"));
+		return finish(false);
+	}
+
+	auto LogAndUpdate = [&](FString logname) {
+		UE_LOG(LogTemp, Log, TEXT("VRM:(%3.3lf secs) %s"), FPlatformTime::Seconds() - StartTime, *logname);
+		StartTime = FPlatformTime::Seconds();
+	};
+	StartTime = FPlatformTime::Seconds();
+
+	// options are global. set again in case another load ran in between
+	VRMConverter::Options::Get().SetVRMModel(data.bVRMModel);
+
+	switch (step++) {
+	case 0:
 	{
+		UpdateProgress(20);
 		FString fullpath = FPaths::GameUserDeveloperDir() + TEXT("VRM/");
 		FString basepath = FPackageName::FilenameToLongPackageName(fullpath);
 		//FPackageName::RegisterMountPoint("/VRMImportData/", fullpath);
 
-		baseFileName = FPaths::GetBaseFilename(filepath);
-
-		//if (VRMConverter::IsImportMode() == false) {
-		//	FString name = basepath + baseFileName + TEXT("/") + VRMConverter::NormalizeFileName(FPaths::GetBaseFilename(filepath));
-		//	package = CreatePackage(nullptr, *name);
-		//}
+		baseFileName = FPaths::GetBaseFilename(data.filepath);
 
 		if (s_vrm_package == nullptr) {
 			s_vrm_package = GetTransientPackage();
 		}
-	}
-	UVrmAssetListObject *out = nullptr;
-	if (s_vrm_package == GetTransientPackage()) {
-		out = Cast<UVrmAssetListObject>(StaticDuplicateObject(InVrmAsset, s_vrm_package, NAME_None));
-	}else {
-		out = NewObject<UVrmAssetListObject>(s_vrm_package, *(FString(TEXT("VA_")) + VRMConverter::NormalizeFileName(baseFileName) + FString(TEXT("_VrmAssetList"))), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone);
-		//out = Cast<UVrmAssetListObject>(StaticDuplicateObject(InVrmAsset, package, *(VRMConverter::NormalizeFileName(baseFileName) + FString(TEXT("_VrmAssetList"))), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone, UVrmAssetListObject::StaticClass()));
-		//out->Modify();
-		InVrmAsset->CopyMember(out);
-	}
-	OutVrmAsset = out;
 
-	if (out == nullptr) {
-		UE_LOG(LogTemp, Warning, TEXT("VRM4U: no UVrmAssetListObject.\n"));
-		return false;
-	}
+		if (s_vrm_package == GetTransientPackage()) {
+			out = Cast<UVrmAssetListObject>(StaticDuplicateObject(InVrmAsset, s_vrm_package, NAME_None));
+		}else {
+			out = NewObject<UVrmAssetListObject>(s_vrm_package, *(FString(TEXT("VA_")) + VRMConverter::NormalizeFileName(baseFileName) + FString(TEXT("_VrmAssetList"))), EObjectFlags::RF_Public | EObjectFlags::RF_Standalone);
+			InVrmAsset->CopyMember(out);
+		}
 
-	out->OrigFileName = baseFileName;
-	out->BaseFileName = VRMConverter::NormalizeFileName(baseFileName);
-	out->Package = s_vrm_package;
+		if (out == nullptr) {
+			UE_LOG(LogTemp, Warning, TEXT("VRM4U: no UVrmAssetListObject.\n"));
+			return finish(false);
+		}
 
-	{
-		bool ret = true;
+		out->OrigFileName = baseFileName;
+		out->BaseFileName = VRMConverter::NormalizeFileName(baseFileName);
+		out->Package = s_vrm_package;
 
+		bConvertResult = data.bBoneName;
 		LogAndUpdate(TEXT("Begin convert"));
-		ret &= VRMConverter::NormalizeBoneName(mScenePtr);
-		LogAndUpdate(TEXT("NormalizeBoneName"));
-		ret &= VRMConverter::ConvertTextureAndMaterial(out, mScenePtr);
+		break;
+	}
+	case 1:
+		bConvertResult &= VRMConverter::ConvertTextureAndMaterial(out, mScenePtr, &data.decodedTexture);
 		LogAndUpdate(TEXT("ConvertTextureAndMaterial"));
 		UpdateProgress(40);
-		{
-			bool r = VRMConverter::ConvertVrmMeta(out, mScenePtr);	// use texture.
-			if (VRMConverter::Options::Get().IsVRMModel() == true) {
-				ret &= r;
-			}
+		break;
+	case 2:
+	{
+		bool r = VRMConverter::ConvertVrmMeta(out, mScenePtr);	// use texture.
+		if (VRMConverter::Options::Get().IsVRMModel() == true) {
+			bConvertResult &= r;
 		}
 		LogAndUpdate(TEXT("ConvertVrmMeta"));
 		UpdateProgress(60);
-		ret &= VRMConverter::ConvertModel(out, mScenePtr);
+		break;
+	}
+	case 3:
+		bConvertResult &= VRMConverter::ConvertModel(out, mScenePtr, data.meshData.Get());
 		LogAndUpdate(TEXT("ConvertModel"));
-		ret &= VRMConverter::ConvertRig(out, mScenePtr);
+		break;
+	case 4:
+		bConvertResult &= VRMConverter::ConvertRig(out, mScenePtr);
 		LogAndUpdate(TEXT("ConvertRig"));
+		break;
+	case 5:
 #if WITH_EDITOR
 		if (out->bSkipMorphTarget == false) {
-			ret &= VRMConverter::ConvertMorphTarget(out, mScenePtr);
+			bConvertResult &= VRMConverter::ConvertMorphTarget(out, mScenePtr, data.meshData.Get());
 			LogAndUpdate(TEXT("ConvertMorphTarget"));
 		}
-		ret &= VRMConverter::ConvertHumanoid(out, mScenePtr);
+#endif
+		break;
+	case 6:
+#if WITH_EDITOR
+		bConvertResult &= VRMConverter::ConvertHumanoid(out, mScenePtr);
 		LogAndUpdate(TEXT("ConvertHumanoid"));
 #endif
 		UpdateProgress(80);
 
-		OutVrmAsset->MeshReturnedData = nullptr;
-		if (ret == false) {
-			return false;
+		out->MeshReturnedData = nullptr;
+		data.meshData = nullptr;
+		if (bConvertResult == false) {
+			return finish(false);
 		}
-	}
-	out->VrmMetaObject->SkeletalMesh = out->SkeletalMesh;
-
+		break;
+	default:
 	{
+		out->VrmMetaObject->SkeletalMesh = out->SkeletalMesh;
+
 		LogAndUpdate(TEXT("BeginSave"));
 		bool b = out->bAssetSave;
 		saveObject(out, b);
@@ -537,29 +535,26 @@ bool ULoaderBPFunctionLibrary::LoadVRMFile(const UVrmAssetListObject *InVrmAsset
 		saveObject(out->HumanoidRig, b);
 
 		LogAndUpdate(TEXT("Save"));
+		UpdateProgress(100);
+		return finish(true);
 	}
+	}
+	return true;
+}
 
-	if (VRMConverter::IsImportMode() == false){
-		//FString fullpath = FPaths::GameUserDeveloperDir() + TEXT("VRM/");
-		//FString basepath = FPackageName::FilenameToLongPackageName(fullpath);
-		//FPackageName::RegisterMountPoint("/VRMImportData/", fullpath);
+bool ULoaderBPFunctionLibrary::LoadVRMFile(const UVrmAssetListObject *InVrmAsset, UVrmAssetListObject *&OutVrmAsset, FString filepath) {
 
-		//ULevel::LevelDirtiedEvent.Broadcast();
+	if (InVrmAsset == nullptr) {
+		return false;
 	}
 
-	// force delete vrmdata
-	if (mScenePtr->mVRMMeta) {
-		auto *a = const_cast<aiScene*>(mScenePtr);
-		if (a) {
-			VRM::VRMMetadata *meta = reinterpret_cast<VRM::VRMMetadata*>(a->mVRMMeta);
-			//VRM::ReleaseVRMMeta(meta);
-			//delete meta;
-			//a->mVRMMeta = nullptr;
-		}
-
+	FVrmLoadTask task(InVrmAsset, filepath);
+	task.GetParseData()->Parse();
+	while (task.FinalizeStep()) {
 	}
-	UpdateProgress(100);
-	return true;
+
+	OutVrmAsset = task.GetResult();
+	return task.IsSuccess();
 }
 
 
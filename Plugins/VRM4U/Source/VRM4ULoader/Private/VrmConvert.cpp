@@ -407,6 +407,44 @@ EVRMImportMaterialType VRMConverter::Options::GetMaterialType() const {
 #endif
 }
 
+static EVRMImportProcessType mProcessType = EVRMImportProcessType::VRMIPT_Fast;
+void VRMConverter::Options::SetProcessType(EVRMImportProcessType t) {
+	mProcessType = t;
+}
+EVRMImportProcessType VRMConverter::Options::GetProcessType() const {
+#if WITH_EDITOR
+	if (Window == nullptr) return mProcessType;
+
+	return Window->ProcessType;
+#else
+	return mProcessType;
+#endif
+}
+
+unsigned int VRMConverter::Options::GetAssimpProcessFlags() const {
+	// GenSmoothNormals only runs on meshes without normals.
+	// Fast leaves tangents to BuildMeshData, which builds them for normal mapped meshes only
+	unsigned int flags = aiProcess_Triangulate | aiProcess_MakeLeftHanded | aiProcess_GenSmoothNormals | aiProcess_OptimizeMeshes;
+	if (GetProcessType() == EVRMImportProcessType::VRMIPT_Full) {
+		flags |= aiProcess_CalcTangentSpace;
+	}
+	return flags;
+}
+
+VRMConverter::VRMParseOption VRMConverter::Options::GetParseOption() const {
+	VRMParseOption o;
+	o.AssimpProcessFlags = GetAssimpProcessFlags();
+	o.ProcessType = GetProcessType();
+	o.bVRMModel = IsVRMModel();
+	o.bImportMode = VRMConverter::IsImportMode();
+	o.bOptimizeVertex = IsOptimizeVertex();
+	o.bDebugOneBone = IsDebugOneBone();
+	o.ModelScale = GetModelScale();
+	o.bMorphTarget = (IsSkipMorphTarget() == false);
+	o.bMorphTargetNormal = IsEnableMorphTargetNormal();
+	return o;
+}
+
 ////
 
 
@@ -0,0 +1,74 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VrmConvert.h"
+#include "LoaderBPFunctionLibrary.h"
+
+#include "Rendering/SkeletalMeshLODRenderData.h"
+#include "Animation/MorphTarget.h"
+#if WITH_EDITOR
+#include "Rendering/SkeletalMeshLODModel.h"
+#endif
+
+#if WITH_EDITOR
+typedef FSoftSkinVertex FSoftSkinVertexLocal;
+
+#else
+struct FSoftSkinVertexLocal
+{
+	FVector			Position;
+
+	// Tangent, U-direction
+	FVector			TangentX;
+	// Binormal, V-direction
+	FVector			TangentY;
+	// Normal
+	FVector4		TangentZ;
+
+	// UVs
+	FVector2D		UVs[MAX_TEXCOORDS];
+	// VertexColor
+	FColor			Color;
+	uint8			InfluenceBones[MAX_TOTAL_INFLUENCES];
+	uint8			InfluenceWeights[MAX_TOTAL_INFLUENCES];
+};
+#endif
+
+// built by BuildMeshData / BuildMorphData on the parse thread.
+// bones are kept by name, the skeleton does not exist yet
+struct VRMConverter::VRMMeshData {
+	struct Section {
+		int32 MeshID = 0;
+		// assimp material
+		uint32 MaterialIndex = 0;
+		int32 BaseVertex = 0;
+		int32 NumVertices = 0;
+		int32 BaseIndex = 0;
+		int32 NumTriangles = 0;
+
+		// InfluenceBones index this. [0] is the root
+		TArray<FName> BoneName;
+		// summed weight per slot. for the mobile bone limit
+		TArray<float> BoneWeight;
+	};
+
+	TSharedPtr<FReturnedData> MeshInfo;
+	TArray<Section> Sections;
+
+	// all sections in a row. weights are normalized
+	TArray<FSoftSkinVertexLocal> Vertex;
+	TArray<uint32> Triangles;
+	int32 UVNum = 1;
+
+	// vertex, index and skin weight buffers. ConvertModel hands it to the mesh
+	TUniquePtr<FSkeletalMeshLODRenderData> RenderData;
+
+	struct Morph {
+		FString Name;
+		TArray<FMorphTargetDelta> Deltas;
+	};
+	// editor only
+	TArray<Morph> Morphs;
+};
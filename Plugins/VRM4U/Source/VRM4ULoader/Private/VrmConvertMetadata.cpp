@@ -17,6 +17,14 @@
 #include "AssetRegistryModule.h"
 #include "UObject/Package.h"
 #include "UObject/UObjectGlobals.h"
+#include "Engine/Texture2D.h"
+#include "Modules/ModuleManager.h"
+#include "IImageWrapperModule.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+#include "VrmMappedIOSystem.h"
 
 static UVrmLicenseObject *tmpLicense = nullptr;
 UVrmLicenseObject* VRMConverter::GetVRMMeta(const aiScene *mScenePtr) {
@@ -175,6 +183,200 @@ bool VRMConverter::ConvertVrmMeta(UVrmAssetListObject *vrmAssetList, const aiSce
 }
 
 
+namespace {
+	const uint32 GLBMagic = 0x46546C67;		// glTF
+	const uint32 GLBChunkJSON = 0x4E4F534A;
+	const uint32 GLBChunkBIN = 0x004E4942;
+
+	TSharedPtr<FJsonObject> GetArrayObject(const FJsonObject &json, const TCHAR *name, int32 index) {
+		const TArray<TSharedPtr<FJsonValue>> *a = nullptr;
+		if (json.TryGetArrayField(name, a) == false || a->IsValidIndex(index) == false) {
+			return nullptr;
+		}
+		const TSharedPtr<FJsonObject> *o = nullptr;
+		if ((*a)[index]->TryGetObject(o) == false) {
+			return nullptr;
+		}
+		return *o;
+	}
+
+	// box filter by an integer step. thumbnails only
+	void ShrinkTexture(VRMConverter::VRMDecodedTexture &t, int32 maxSize) {
+		const int32 step = FMath::DivideAndRoundUp(FMath::Max(t.Width, t.Height), FMath::Max(maxSize, 1));
+		if (step <= 1) {
+			return;
+		}
+		const int32 dW = FMath::Max(t.Width / step, 1);
+		const int32 dH = FMath::Max(t.Height / step, 1);
+
+		TArray<uint8> dst;
+		dst.SetNumUninitialized(dW * dH * 4);
+		for (int32 y = 0; y < dH; ++y) {
+			for (int32 x = 0; x < dW; ++x) {
+				int32 tmp[4] = {};
+				int32 c = 0;
+				for (int32 ry = y * step; ry < FMath::Min((y + 1) * step, t.Height); ++ry) {
+					for (int32 rx = x * step; rx < FMath::Min((x + 1) * step, t.Width); ++rx) {
+						const uint8 *rp = &t.BGRA[(ry * t.Width + rx) * 4];
+						tmp[0] += rp[0];
+						tmp[1] += rp[1];
+						tmp[2] += rp[2];
+						tmp[3] += rp[3];
+						++c;
+					}
+				}
+				uint8 *dp = &dst[(y * dW + x) * 4];
+				for (int i = 0; i < 4; ++i) {
+					dp[i] = (uint8)(tmp[i] / FMath::Max(c, 1));
+				}
+			}
+		}
+		t.Width = dW;
+		t.Height = dH;
+		t.BGRA = MoveTemp(dst);
+	}
+
+	UTexture2D *CreateThumbnail(const VRMConverter::VRMDecodedTexture &d) {
+		UTexture2D *tex = VRMConverter::CreateTexture(d.Width, d.Height, TEXT("T_"), GetTransientPackage());
+		if (tex == nullptr) {
+			return nullptr;
+		}
+		uint8* MipData = (uint8*)tex->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
+		FMemory::Memcpy(MipData, d.BGRA.GetData(), d.BGRA.Num());
+		tex->PlatformData->Mips[0].BulkData.Unlock();
+
+		tex->SRGB = true;
+		tex->CompressionSettings = TC_Default;
+		tex->AddressX = TA_Wrap;
+		tex->AddressY = TA_Wrap;
+#if WITH_EDITORONLY_DATA
+		tex->CompressionNone = false;
+		tex->DeferCompression = true;
+		tex->MipGenSettings = TMGS_NoMipmaps;
+		tex->Source.Init(d.Width, d.Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, d.BGRA.GetData());
+#endif
+		tex->UpdateResource();
+#if WITH_EDITOR
+		tex->PostEditChange();
+#endif
+		return tex;
+	}
+}
+
+UVrmLicenseObject* VRMConverter::GetVRMMetaFromGLB(const FString &filepath, int32 thumbnailSize) {
+	TUniquePtr<VRMMappedIOStream> s(VRMMappedIOStream::Open(filepath));
+	if (s.IsValid() == false) {
+		return nullptr;
+	}
+
+	// magic, version, length / chunk length, type
+	uint32 header[3] = {};
+	uint32 chunk[2] = {};
+	if (s->Read(header, sizeof(header), 1) != 1 || header[0] != GLBMagic || header[1] != 2) {
+		return nullptr;
+	}
+	if (s->Read(chunk, sizeof(chunk), 1) != 1 || chunk[1] != GLBChunkJSON || chunk[0] == 0) {
+		return nullptr;
+	}
+	TArray<uint8> jsonText;
+	jsonText.SetNumUninitialized(chunk[0]);
+	if (s->Read(jsonText.GetData(), jsonText.Num(), 1) != 1) {
+		return nullptr;
+	}
+	uint32 bin[2] = {};
+	const bool bBin = (s->Read(bin, sizeof(bin), 1) == 1 && bin[1] == GLBChunkBIN);
+	const size_t binOffset = s->Tell();
+
+	TSharedPtr<FJsonObject> json;
+	{
+		FUTF8ToTCHAR conv((const ANSICHAR*)jsonText.GetData(), jsonText.Num());
+		TSharedRef<TJsonReader<TCHAR>> reader = TJsonReaderFactory<TCHAR>::Create(FString(conv.Length(), conv.Get()));
+		if (FJsonSerializer::Deserialize(reader, json) == false || json.IsValid() == false) {
+			return nullptr;
+		}
+	}
+
+	// same as the assimp path. glb without vrm gives an empty license
+	UVrmLicenseObject *lic = NewObject<UVrmLicenseObject>(GetTransientPackage(), NAME_None, EObjectFlags::RF_Public | RF_Transient, NULL);
+
+	const TSharedPtr<FJsonObject> *ext = nullptr;
+	const TSharedPtr<FJsonObject> *vrm = nullptr;
+	const TSharedPtr<FJsonObject> *meta = nullptr;
+	if (json->TryGetObjectField(TEXT("extensions"), ext) == false
+		|| (*ext)->TryGetObjectField(TEXT("VRM"), vrm) == false
+		|| (*vrm)->TryGetObjectField(TEXT("meta"), meta) == false) {
+		return lic;
+	}
+
+	{
+		struct TT {
+			const TCHAR *key;
+			FString &dst;
+		};
+		const TT table[] = {
+			{TEXT("version"),		lic->version},
+			{TEXT("author"),			lic->author},
+			{TEXT("contactInformation"),	lic->contactInformation},
+			{TEXT("reference"),		lic->reference},
+			{TEXT("title"),			lic->title},
+			{TEXT("allowedUserName"),	lic->allowedUserName},
+			{TEXT("violentUssageName"),	lic->violentUssageName},
+			{TEXT("sexualUssageName"),	lic->sexualUssageName},
+			{TEXT("commercialUssageName"),	lic->commercialUssageName},
+			{TEXT("otherPermissionUrl"),		lic->otherPermissionUrl},
+			{TEXT("licenseName"),			lic->licenseName},
+			{TEXT("otherLicenseUrl"),		lic->otherLicenseUrl},
+		};
+		for (auto &t : table) {
+			(*meta)->TryGetStringField(t.key, t.dst);
+		}
+	}
+
+	// thumbnail. texture -> image -> bufferView in the BIN chunk
+	int32 texIndex = -1;
+	if (bBin == false || (*meta)->TryGetNumberField(TEXT("texture"), texIndex) == false) {
+		return lic;
+	}
+	int32 imageIndex = -1;
+	int32 viewIndex = -1;
+	const TSharedPtr<FJsonObject> tex = GetArrayObject(*json, TEXT("textures"), texIndex);
+	if (tex.IsValid() == false || tex->TryGetNumberField(TEXT("source"), imageIndex) == false) {
+		return lic;
+	}
+	const TSharedPtr<FJsonObject> image = GetArrayObject(*json, TEXT("images"), imageIndex);
+	if (image.IsValid() == false || image->TryGetNumberField(TEXT("bufferView"), viewIndex) == false) {
+		return lic;
+	}
+	const TSharedPtr<FJsonObject> view = GetArrayObject(*json, TEXT("bufferViews"), viewIndex);
+	if (view.IsValid() == false) {
+		return lic;
+	}
+	int32 buffer = 0;
+	int32 byteOffset = 0;
+	int32 byteLength = 0;
+	view->TryGetNumberField(TEXT("buffer"), buffer);
+	view->TryGetNumberField(TEXT("byteOffset"), byteOffset);
+	if (buffer != 0 || view->TryGetNumberField(TEXT("byteLength"), byteLength) == false
+		|| byteOffset < 0 || byteLength <= 0 || (uint32)byteOffset + (uint32)byteLength > bin[0]) {
+		return lic;
+	}
+
+	TArray<uint8> compressed;
+	compressed.SetNumUninitialized(byteLength);
+	if (s->Seek(binOffset + byteOffset, aiOrigin_SET) != aiReturn_SUCCESS || s->Read(compressed.GetData(), byteLength, 1) != 1) {
+		return lic;
+	}
+	s.Reset();
+
+	FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	VRMDecodedTexture decoded;
+	if (DecodeTexture(compressed.GetData(), compressed.Num(), decoded)) {
+		ShrinkTexture(decoded, thumbnailSize);
+		lic->thumbnail = CreateThumbnail(decoded);
+	}
+	return lic;
+}
+
 
 VrmConvertMetadata::VrmConvertMetadata()
 {
@@ -3,6 +3,7 @@
 
 #include "VrmConvertModel.h"
 #include "VrmConvert.h"
+#include "VrmConvertMeshData.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -12,6 +13,7 @@
 #include <assimp/vrm/vrmmeta.h>
 
 #include "VrmAssetListObject.h"
+#include "VrmMetaObject.h"
 #include "VrmSkeleton.h"
 #include "LoaderBPFunctionLibrary.h"
 
@@ -32,46 +34,6 @@
 #include "Async/ParallelFor.h"
 
 
-#if WITH_EDITOR
-typedef FSoftSkinVertex FSoftSkinVertexLocal;
-
-#else
-namespace {
-	struct FSoftSkinVertexLocal
-	{
-		FVector			Position;
-
-		// Tangent, U-direction
-		FVector			TangentX;
-		// Binormal, V-direction
-		FVector			TangentY;
-		// Normal
-		FVector4		TangentZ;
-
-		// UVs
-		FVector2D		UVs[MAX_TEXCOORDS];
-		// VertexColor
-		FColor			Color;
-		uint8			InfluenceBones[MAX_TOTAL_INFLUENCES];
-		uint8			InfluenceWeights[MAX_TOTAL_INFLUENCES];
-
-		/** If this vert is rigidly weighted to a bone, return true and the bone index. Otherwise return false. */
-		//ENGINE_API bool GetRigidWeightBone(uint8& OutBoneIndex) const;
-
-		/** Returns the maximum weight of any bone that influences this vertex. */
-		//ENGINE_API uint8 GetMaximumWeight() const;
-
-		/**
-		* Serializer
-		*
-		* @param Ar - archive to serialize with
-		* @param V - vertex to serialize
-		* @return archive that was used
-		*/
-		//friend FArchive& operator<<(FArchive& Ar, FSoftSkinVertex& V);
-	};
-}
-#endif
 
 namespace {
 	struct BoneMapOpt {
@@ -131,7 +93,65 @@ static int GetChildBoneLocal(const USkeleton *skeleton, const int32 ParentBoneIn
 
 
 
-static void FindMeshInfo(const aiScene* scene, aiNode* node, FReturnedData& result)
+static bool HasNormalMap(const aiScene *scene, const aiMesh *mesh) {
+	const uint32 m = mesh->mMaterialIndex;
+	const VRM::VRMMetadata *meta = static_cast<const VRM::VRMMetadata*>(scene->mVRMMeta);
+	if (meta && (int)m < meta->materialNum) {
+		if (meta->material[m].textureProperties._BumpMap >= 0) {
+			return true;
+		}
+	}
+	if (m < scene->mNumMaterials) {
+		return scene->mMaterials[m]->GetTextureCount(aiTextureType_NORMALS) > 0;
+	}
+	return false;
+}
+
+// tangent from uv gradient per face, same as aiProcess_CalcTangentSpace. any thread
+static void CalcMeshTangent(const aiMesh *mesh, TArray<FVector> &out) {
+	auto V = [](const aiVector3D &v) {
+		return FVector(v.x, v.y, v.z);
+	};
+	const aiVector3D *uv = mesh->mTextureCoords[0];
+
+	out.SetNumZeroed(mesh->mNumVertices);
+	for (uint32 f = 0; f < mesh->mNumFaces; ++f) {
+		const aiFace &face = mesh->mFaces[f];
+		if (face.mNumIndices != 3) {
+			continue;
+		}
+		const uint32 i0 = face.mIndices[0];
+		const uint32 i1 = face.mIndices[1];
+		const uint32 i2 = face.mIndices[2];
+
+		const FVector e1 = V(mesh->mVertices[i1]) - V(mesh->mVertices[i0]);
+		const FVector e2 = V(mesh->mVertices[i2]) - V(mesh->mVertices[i0]);
+		const float du1 = uv[i1].x - uv[i0].x;
+		const float dv1 = uv[i1].y - uv[i0].y;
+		const float du2 = uv[i2].x - uv[i0].x;
+		const float dv2 = uv[i2].y - uv[i0].y;
+
+		const float r = du1 * dv2 - du2 * dv1;
+		if (FMath::Abs(r) < SMALL_NUMBER) {
+			continue;
+		}
+		const FVector t = (e1 * dv2 - e2 * dv1) / r;
+		out[i0] += t;
+		out[i1] += t;
+		out[i2] += t;
+	}
+	for (uint32 i = 0; i < mesh->mNumVertices; ++i) {
+		const FVector n = V(mesh->mNormals[i]).GetSafeNormal();
+		FVector t = out[i] - n * (n | out[i]);
+		if (t.Normalize() == false) {
+			FVector b;
+			n.FindBestAxisVectors(t, b);
+		}
+		out[i] = t;
+	}
+}
+
+static void FindMeshInfo(const aiScene* scene, aiNode* node, FReturnedData& result, const TArray<TArray<FVector>> &genTangent, bool bOptimizeVertex)
 {
 	for (uint32 i = 0; i < node->mNumMeshes; i++)
 	{
@@ -183,7 +203,7 @@ static void FindMeshInfo(const aiScene* scene, aiNode* node, FReturnedData& resu
 		mi.RelativeTransform = FTransform(tempMatrix);
 
 		auto &useFlag = mi.vertexUseFlag;
-		if (VRMConverter::Options::Get().IsOptimizeVertex()) {
+		if (bOptimizeVertex) {
 			// no morphtarget
 			// optimize vertex
 
@@ -296,6 +316,8 @@ static void FindMeshInfo(const aiScene* scene, aiNode* node, FReturnedData& resu
 				//FProcMeshTangent meshTangent = FProcMeshTangent(v.X, v.Y, v.Z);
 				mi.Tangents.Push(v);
 				//mi.MeshTangents.Push(meshTangent);
+			} else if (j < (uint32)genTangent[meshidx].Num()) {
+				mi.Tangents.Push(genTangent[meshidx][j]);
 			}
 
 			//Vertex color
@@ -315,13 +337,13 @@ static void FindMeshInfo(const aiScene* scene, aiNode* node, FReturnedData& resu
 }
 
 
-static void FindMesh(const aiScene* scene, aiNode* node, FReturnedData& retdata)
+static void FindMesh(const aiScene* scene, aiNode* node, FReturnedData& retdata, const TArray<TArray<FVector>> &genTangent, bool bOptimizeVertex)
 {
-	FindMeshInfo(scene, node, retdata);
+	FindMeshInfo(scene, node, retdata, genTangent, bOptimizeVertex);
 
 	for (uint32 m = 0; m < node->mNumChildren; ++m)
 	{
-		FindMesh(scene, node->mChildren[m], retdata);
+		FindMesh(scene, node->mChildren[m], retdata, genTangent, bOptimizeVertex);
 	}
 }
 
@@ -563,14 +585,54 @@ static void CreateSwingHead(UVrmAssetListObject *vrmAssetList, VRM::VRMSpring &s
 	*/
 }
 
-bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr) {
-	if (vrmAssetList == nullptr) {
-		return false;
+static void NormalizeWeight(FSoftSkinVertexLocal &w, int &warnCount) {
+	int f = 0;
+	int maxIndex = 0;
+	int maxWeight = 0;
+	for (int i = 0; i < 8; ++i) {
+		f += w.InfluenceWeights[i];
+
+		if (maxWeight < w.InfluenceWeights[i]) {
+			maxWeight = w.InfluenceWeights[i];
+			maxIndex = i;
+		}
+	}
+	if (f > 255) {
+		UE_LOG(LogTemp, Warning, TEXT("overr"));
+		w.InfluenceWeights[0] -= (uint8)(f - 255);
+	}
+	if (f <= 254) {
+		if (f <= (255 - 8)) {
+			if (warnCount < 50) {
+				UE_LOG(LogTemp, Warning, TEXT("less"));
+				warnCount++;
+			}
+		}
+		w.InfluenceWeights[maxIndex] += (uint8)(255 - f);
+	}
+}
+
+static void InitSkinWeight(FSkeletalMeshLODRenderData &rd, const TArray<FSoftSkinVertexLocal> &Weight) {
+#if WITH_EDITOR
+	rd.SkinWeightVertexBuffer.Init(Weight);
+#else
+	TArray< TSkinWeightInfo<false> > InWeights;
+	InWeights.Reserve(Weight.Num());
+
+	for (const auto &a : Weight) {
+		auto n = new(InWeights) TSkinWeightInfo<false>;
+
+		memcpy(n->InfluenceBones, a.InfluenceBones, sizeof(n->InfluenceBones));
+		memcpy(n->InfluenceWeights, a.InfluenceWeights, sizeof(n->InfluenceWeights));
 	}
+	rd.SkinWeightVertexBuffer = InWeights;
+#endif
+}
 
-	vrmAssetList->MeshReturnedData = MakeShareable(new FReturnedData());
-	FReturnedData &result = *(vrmAssetList->MeshReturnedData);
-	//FReturnedData &result = *(vrmAssetList->Result);
+TSharedPtr<VRMConverter::VRMMeshData, ESPMode::ThreadSafe> VRMConverter::BuildMeshData(const aiScene *mScenePtr, const VRMParseOption &option) {
+	TSharedPtr<VRMMeshData, ESPMode::ThreadSafe> meshData = MakeShareable(new VRMMeshData());
+	meshData->MeshInfo = MakeShareable(new FReturnedData());
+	FReturnedData &result = *(meshData->MeshInfo);
 
 	result.bSuccess = false;
 	result.meshInfo.Empty();
@@ -579,13 +641,29 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 	if (mScenePtr == nullptr)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("test null.\n"));
+		return meshData;
 	}
 
 	if (mScenePtr->HasMeshes())
 	{
 		result.meshInfo.SetNum(mScenePtr->mNumMeshes, false);
 
-		FindMesh(mScenePtr, mScenePtr->mRootNode, result);
+		// tangents assimp did not make. only where a normal map needs them
+		TArray<TArray<FVector>> genTangent;
+		genTangent.SetNum(mScenePtr->mNumMeshes);
+		if (option.ProcessType != EVRMImportProcessType::VRMIPT_Full) {
+			ParallelFor(mScenePtr->mNumMeshes, [&](int32 i) {
+				const aiMesh *mesh = mScenePtr->mMeshes[i];
+				if (mesh->HasTangentsAndBitangents() || mesh->HasNormals() == false || mesh->HasTextureCoords(0) == false) {
+					return;
+				}
+				if (HasNormalMap(mScenePtr, mesh)) {
+					CalcMeshTangent(mesh, genTangent[i]);
+				}
+			});
+		}
+
+		FindMesh(mScenePtr, mScenePtr->mRootNode, result, genTangent, option.bOptimizeVertex);
 
 		for (uint32 i = 0; i < mScenePtr->mNumMeshes; ++i)
 		{
@@ -604,6 +682,230 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 		result.bSuccess = true;
 	}
 
+	int allIndex = 0;
+	int allVertex = 0;
+	int uvNum = 1;
+	{
+		for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
+			allIndex += result.meshInfo[meshID].Triangles.Num();
+			allVertex += result.meshInfo[meshID].Vertices.Num();
+		}
+		for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
+			auto &mInfo = result.meshInfo[meshID];
+			uvNum = FMath::Max(uvNum, mInfo.UV0.Num());
+			if (uvNum >= 2) {
+				UE_LOG(LogTemp, Warning, TEXT("test uv2.\n"));
+			}
+		}
+		// soft vertex holds MAX_TEXCOORDS
+		uvNum = FMath::Min(uvNum, (int)MAX_TEXCOORDS);
+	}
+	meshData->UVNum = uvNum;
+
+	FSoftSkinVertexLocal softSkinVertexLocalZero;
+	{
+#if	UE_VERSION_OLDER_THAN(4,20,0)
+		{
+			FPackedNormal n(0);
+			softSkinVertexLocalZero.Position = FVector::ZeroVector;
+			softSkinVertexLocalZero.TangentX = softSkinVertexLocalZero.TangentY = softSkinVertexLocalZero.TangentZ = n;
+		}
+#else
+		softSkinVertexLocalZero.Position = softSkinVertexLocalZero.TangentX = softSkinVertexLocalZero.TangentY = FVector::ZeroVector;
+		softSkinVertexLocalZero.TangentZ.Set(0, 0, 0, 1);
+#endif
+		softSkinVertexLocalZero.Color = FColor::White;
+
+		memset(softSkinVertexLocalZero.UVs, 0, sizeof(softSkinVertexLocalZero.UVs));
+		memset(softSkinVertexLocalZero.InfluenceBones, 0, sizeof(softSkinVertexLocalZero.InfluenceBones));
+		memset(softSkinVertexLocalZero.InfluenceWeights, 0, sizeof(softSkinVertexLocalZero.InfluenceWeights));
+	}
+
+	TArray<FSoftSkinVertexLocal> &Weight = meshData->Vertex;
+	Weight.Init(softSkinVertexLocalZero, allVertex);
+
+	meshData->Sections.SetNum(result.meshInfo.Num());
+	{
+		int currentIndex = 0;
+		int currentVertex = 0;
+		for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
+			auto &sec = meshData->Sections[meshID];
+			sec.MeshID = meshID;
+			sec.MaterialIndex = mScenePtr->mMeshes[meshID]->mMaterialIndex;
+			sec.BaseVertex = currentVertex;
+			sec.NumVertices = result.meshInfo[meshID].Vertices.Num();
+			sec.BaseIndex = currentIndex;
+			sec.NumTriangles = result.meshInfo[meshID].Triangles.Num() / 3;
+
+			currentIndex += result.meshInfo[meshID].Triangles.Num();
+			currentVertex += result.meshInfo[meshID].Vertices.Num();
+		}
+	}
+
+	meshData->RenderData = MakeUnique<FSkeletalMeshLODRenderData>();
+	FSkeletalMeshLODRenderData &rd = *(meshData->RenderData);
+	FStaticMeshVertexBuffers &v = rd.StaticVertexBuffers;
+
+	v.PositionVertexBuffer.Init(allVertex);
+	v.ColorVertexBuffer.InitFromSingleColor(FColor(255, 255, 255, 255), allVertex);
+	v.StaticMeshVertexBuffer.Init(allVertex, uvNum);
+
+	// each mesh writes its own vertex range
+	ParallelFor(result.meshInfo.Num(), [&](int32 meshID) {
+		auto &sec = meshData->Sections[meshID];
+		auto &mInfo = result.meshInfo[meshID];
+		const int currentVertex = sec.BaseVertex;
+
+		for (int i = 0; i < mInfo.Vertices.Num(); ++i) {
+			FSoftSkinVertexLocal &s = Weight[currentVertex + i];
+			auto a = mInfo.Vertices[i] * 100.f;
+
+			FVector pos(-a.X, a.Z, a.Y);
+			if (option.bVRMModel == false) {
+				pos.Set(a.X, -a.Z, a.Y);
+			}
+			pos *= option.ModelScale;
+			v.PositionVertexBuffer.VertexPosition(currentVertex + i) = pos;
+			s.Position = pos;
+
+			for (int u = 0; u < FMath::Min(mInfo.UV0.Num(), uvNum); ++u) {
+				FVector2D uv(0, 0);
+				if (i < mInfo.UV0[u].Num()) {
+					uv = mInfo.UV0[u][i];
+				}
+				v.StaticMeshVertexBuffer.SetVertexUV(currentVertex + i, u, uv);
+				s.UVs[u] = uv;
+			}
+
+			if (i < mInfo.Tangents.Num()) {
+				auto &n = mInfo.Normals[i];
+				FVector n_tmp(-n.X, n.Z, n.Y);
+				FVector t_tmp(-mInfo.Tangents[i].X, mInfo.Tangents[i].Z, mInfo.Tangents[i].Y);
+
+				t_tmp.Normalize();
+				n_tmp.Normalize();
+
+				s.TangentX = t_tmp;
+				s.TangentY = n_tmp ^ t_tmp;
+				s.TangentZ = n_tmp;
+
+				v.StaticMeshVertexBuffer.SetVertexTangents(currentVertex + i, s.TangentX, s.TangentY, s.TangentZ);
+
+			} else if (i < mInfo.Normals.Num()) {
+				// no normal map. any basis around the normal
+				auto &n = mInfo.Normals[i];
+				FVector n_tmp(-n.X, n.Z, n.Y);
+				n_tmp.Normalize();
+
+				FVector t_tmp, b_tmp;
+				n_tmp.FindBestAxisVectors(t_tmp, b_tmp);
+
+				s.TangentX = t_tmp;
+				s.TangentY = n_tmp ^ t_tmp;
+				s.TangentZ = n_tmp;
+
+				v.StaticMeshVertexBuffer.SetVertexTangents(currentVertex + i, s.TangentX, s.TangentY, s.TangentZ);
+			}
+
+			if (i < mInfo.VertexColors.Num()) {
+				auto &c = mInfo.VertexColors[i];
+				s.Color = FColor(c.R, c.G, c.B, c.A);
+			}
+		} // vertex loop
+
+		// weight. bones by name, ConvertModel resolves them on the skeleton
+		const aiMesh *aiM = mScenePtr->mMeshes[meshID];
+		sec.BoneName.Add(NAME_None);
+		sec.BoneWeight.Add(-1.f);
+		for (uint32 boneIndex = 0; boneIndex < aiM->mNumBones; ++boneIndex) {
+			auto &aiB = aiM->mBones[boneIndex];
+			const FName boneName = UTF8_TO_TCHAR(aiB->mName.C_Str());
+
+			for (uint32 weightIndex = 0; weightIndex < aiB->mNumWeights; ++weightIndex) {
+				auto &aiW = aiB->mWeights[weightIndex];
+
+				if (aiW.mWeight == 0.f) {
+					continue;
+				}
+				for (int jj = 0; jj < 8; ++jj) {
+					auto &s = Weight[aiW.mVertexId + currentVertex];
+					if (s.InfluenceWeights[jj] > 0) {
+						continue;
+					}
+
+					int tabledIndex = 0;
+					if (option.bDebugOneBone == false) {
+						tabledIndex = sec.BoneName.Find(boneName);
+						if (tabledIndex == INDEX_NONE) {
+							tabledIndex = sec.BoneName.Add(boneName);
+							sec.BoneWeight.Add(0.f);
+						}
+					}
+					if (tabledIndex > 255) {
+						UE_LOG(LogTemp, Warning, TEXT("bonemap over!"));
+					}
+
+					const float ww = FMath::Clamp(aiW.mWeight, 0.f, 1.f);
+					s.InfluenceBones[jj] = tabledIndex;
+					s.InfluenceWeights[jj] = (uint8)FMath::TruncToInt(ww * 255.f);
+
+					if (tabledIndex > 0) {
+						sec.BoneWeight[tabledIndex] += aiW.mWeight;
+					}
+					break;
+				}
+			}
+		}// bone loop
+
+		int warnCount = 0;
+		for (int i = 0; i < sec.NumVertices; ++i) {
+			NormalizeWeight(Weight[currentVertex + i], warnCount);
+		}
+	});
+
+	TArray<uint32> &Triangles = meshData->Triangles;
+	Triangles.Reserve(allIndex);
+	for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
+		int t1 = Triangles.Num();
+		Triangles.Append(result.meshInfo[meshID].Triangles);
+		int t2 = Triangles.Num();
+
+		for (int i = t1; i < t2; ++i) {
+			Triangles[i] += meshData->Sections[meshID].BaseVertex;
+		}
+	}
+
+	// cpu side only. InitResources on the game thread enqueues the upload
+	if (option.bImportMode == false) {
+		rd.MultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), Triangles);
+		rd.AdjacencyMultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), Triangles);
+		InitSkinWeight(rd, Weight);
+	} else {
+		TArray<FSoftSkinVertexLocal> zero;
+		zero.Init(softSkinVertexLocalZero, allVertex);
+		InitSkinWeight(rd, zero);
+	}
+
+	return meshData;
+}
+
+bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, VRMMeshData *meshData) {
+	if (vrmAssetList == nullptr) {
+		return false;
+	}
+
+	TSharedPtr<VRMMeshData, ESPMode::ThreadSafe> localMeshData;
+	if (meshData == nullptr) {
+		localMeshData = BuildMeshData(mScenePtr, Options::Get().GetParseOption());
+		meshData = localMeshData.Get();
+	}
+	if (meshData->RenderData.IsValid() == false) {
+		UE_LOG(LogTemp, Warning, TEXT("VRM4U: no mesh data.\n"));
+		return false;
+	}
+
+	vrmAssetList->MeshReturnedData = meshData->MeshInfo;
+
 	USkeletalMesh *sk = nullptr;
 	if (vrmAssetList->Package == GetTransientPackage()) {
 		sk = NewObject<USkeletalMesh>(GetTransientPackage(), NAME_None, EObjectFlags::RF_Public | RF_Transient);
@@ -670,22 +972,8 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 		}
 	}
 
-	int allIndex = 0;
-	int allVertex = 0;
-	int uvNum = 1;
-	{
-		for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
-			allIndex += result.meshInfo[meshID].Triangles.Num();
-			allVertex += result.meshInfo[meshID].Vertices.Num();
-		}
-		for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
-			auto &mInfo = result.meshInfo[meshID];
-			uvNum = FMath::Max(uvNum, mInfo.UV0.Num());
-			if (uvNum >= 2) {
-				UE_LOG(LogTemp, Warning, TEXT("test uv2.\n"));
-			}
-		}
-	}
+	const int allVertex = meshData->Vertex.Num();
+	const int uvNum = meshData->UVNum;
 
 	static int boneOffset = 0;
 	{
@@ -753,6 +1041,11 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 
 		vrmAssetList->SkeletalMesh = sk;
 
+		// spring bone chains for the runtime
+		if (vrmAssetList->VrmMetaObject) {
+			vrmAssetList->VrmMetaObject->BakeSpringBone(sk->RefSkeleton);
+		}
+
 #if	UE_VERSION_OLDER_THAN(4,20,0)
 		sk->LODInfo.AddZeroed(1);
 		//const USkeletalMeshLODSettings* DefaultSetting = sk->GetDefaultLODSetting();
@@ -770,37 +1063,9 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 		FSkeletalMeshRenderData *p = sk->GetResourceForRendering();
 		//p->Cache(sk);
 		//sk->OnPostMeshCached().Broadcast(sk);
-#if	UE_VERSION_OLDER_THAN(4,23,0)
-		FSkeletalMeshLODRenderData *pRd = new(p->LODRenderData) FSkeletalMeshLODRenderData();
-#else
-		FSkeletalMeshLODRenderData *pRd = new FSkeletalMeshLODRenderData();
-		p->LODRenderData.Add(pRd);
-#endif
-
-		{
-			pRd->StaticVertexBuffers.PositionVertexBuffer.Init(allVertex);
-			pRd->StaticVertexBuffers.ColorVertexBuffer.InitFromSingleColor(FColor(255, 255, 255, 255), allVertex);
-			pRd->StaticVertexBuffers.StaticMeshVertexBuffer.Init(allVertex, uvNum);
 
-
-#if WITH_EDITOR
-			TArray<FSoftSkinVertex> Weight;
-			Weight.SetNum(allVertex);
-			pRd->SkinWeightVertexBuffer.Init(Weight);
-#else
-			{
-				TArray< TSkinWeightInfo<false> > InWeights;
-				InWeights.SetNum(allVertex);
-				for (auto &a : InWeights) {
-					memset(a.InfluenceBones, 0, sizeof(a.InfluenceBones));
-					memset(a.InfluenceWeights, 0, sizeof(a.InfluenceWeights));
-				}
-				pRd->SkinWeightVertexBuffer = InWeights;
-			}
-#endif
-		}
-
-		sk->InitResources();
+		// vertex, index and skin weight buffers are filled by BuildMeshData
+		p->LODRenderData.Add(meshData->RenderData.Release());
 
 		sk->Materials.SetNum(vrmAssetList->Materials.Num());
 		for (int i = 0; i < sk->Materials.Num(); ++i) {
@@ -831,37 +1096,9 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 			}
 		}
 		{
-			FStaticMeshVertexBuffers	 &v = rd.StaticVertexBuffers;
-
-			FSoftSkinVertexLocal softSkinVertexLocalZero;
-			{
-#if	UE_VERSION_OLDER_THAN(4,20,0)
-				{
-					FPackedNormal n(0);
-					softSkinVertexLocalZero.Position = FVector::ZeroVector;
-					softSkinVertexLocalZero.TangentX = softSkinVertexLocalZero.TangentY = softSkinVertexLocalZero.TangentZ = n;
-				}
-#else
-				softSkinVertexLocalZero.Position = softSkinVertexLocalZero.TangentX = softSkinVertexLocalZero.TangentY = FVector::ZeroVector;
-				softSkinVertexLocalZero.TangentZ.Set(0, 0, 0, 1);
-#endif
-				softSkinVertexLocalZero.Color = FColor::White;
-
-				memset(softSkinVertexLocalZero.UVs, 0, sizeof(softSkinVertexLocalZero.UVs));
-				memset(softSkinVertexLocalZero.InfluenceBones, 0, sizeof(softSkinVertexLocalZero.InfluenceBones));
-				memset(softSkinVertexLocalZero.InfluenceWeights, 0, sizeof(softSkinVertexLocalZero.InfluenceWeights));
-			}
-
-			TArray<uint32> Triangles;
-			TArray<FSoftSkinVertexLocal> Weight;
-			Weight.SetNum(allVertex);
-			for (auto &w : Weight) {
-				w = softSkinVertexLocalZero;
-			}
-
-			//Weight.AddZeroed(allVertex);
-			int currentIndex = 0;
-			int currentVertex = 0;
+			// bone slots of each section were filled by name. map them to the skeleton
+			TArray<FSoftSkinVertexLocal> &Weight = meshData->Vertex;
+			bool bWeightChanged = false;
 
 #if WITH_EDITORONLY_DATA
 #if	UE_VERSION_OLDER_THAN(4,23,0)
@@ -869,79 +1106,15 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 #else
 			sk->GetImportedModel()->LODModels.Add(new FSkeletalMeshLODModel());
 #endif
-			sk->GetImportedModel()->LODModels[0].Sections.SetNum(result.meshInfo.Num());
+			sk->GetImportedModel()->LODModels[0].Sections.SetNum(meshData->Sections.Num());
 #endif
 
-			for (int meshID = 0; meshID < result.meshInfo.Num(); ++meshID) {
-				TArray<FSoftSkinVertexLocal> meshWeight;
-				auto &mInfo = result.meshInfo[meshID];
-
-				for (int i = 0; i < mInfo.Vertices.Num(); ++i) {
-					FSoftSkinVertexLocal *meshS = new(meshWeight) FSoftSkinVertexLocal();
-					*meshS = softSkinVertexLocalZero;
-					auto a = result.meshInfo[meshID].Vertices[i] * 100.f;
-
-					v.PositionVertexBuffer.VertexPosition(currentVertex + i).Set(-a.X, a.Z, a.Y);
-					if (VRMConverter::Options::Get().IsVRMModel() == false) {
-						v.PositionVertexBuffer.VertexPosition(currentVertex + i).Set(a.X, -a.Z, a.Y);
-					}
-					v.PositionVertexBuffer.VertexPosition(currentVertex + i) *= VRMConverter::Options::Get().GetModelScale();
-
-					for (int u=0; u<mInfo.UV0.Num(); ++u){
-						FVector2D uv(0, 0);
-						if (i < mInfo.UV0[u].Num()) {
-							uv = mInfo.UV0[u][i];
-						}
-						v.StaticMeshVertexBuffer.SetVertexUV(currentVertex + i, u, uv);
-						meshS->UVs[u] = uv;
-					}
-
-					if (i < mInfo.Tangents.Num()){
-						//v.StaticMeshVertexBuffer.SetVertexTangents(currentVertex + i, FVector(1, 0, 0), FVector(0, 1, 0), FVector(0, 0, 1));
-						//v.StaticMeshVertexBuffer.SetVertexTangents(currentVertex + i, result.meshInfo[meshID].Tangents);
-						auto &n = mInfo.Normals[i];
-						FVector n_tmp(-n.X, n.Z, n.Y);
-						FVector t_tmp(-mInfo.Tangents[i].X, mInfo.Tangents[i].Z, mInfo.Tangents[i].Y);
-
-						t_tmp.Normalize();
-						n_tmp.Normalize();
-
-						meshS->TangentX = t_tmp;
-						meshS->TangentY = n_tmp ^ t_tmp;
-						meshS->TangentZ = n_tmp;
-
-						v.StaticMeshVertexBuffer.SetVertexTangents(currentVertex + i, meshS->TangentX, meshS->TangentY, meshS->TangentZ);
-
-					}
-
-					if (i < mInfo.VertexColors.Num()) {
-						auto &c = mInfo.VertexColors[i];
-						meshS->Color = FColor(c.R, c.G, c.B, c.A);
-					}
-
-					auto aiS = rd.SkinWeightVertexBuffer.GetSkinWeightPtr<false>(i);
-					//aiS->InfluenceWeights
-					// InfluenceBones
-
-					FSoftSkinVertexLocal &s = Weight[currentVertex + i];
-					s.Position = v.PositionVertexBuffer.VertexPosition(currentVertex + i);
-					meshS->Position = v.PositionVertexBuffer.VertexPosition(currentVertex + i);
+			for (int meshID = 0; meshID < meshData->Sections.Num(); ++meshID) {
+				const auto &sec = meshData->Sections[meshID];
+				const int currentVertex = sec.BaseVertex;
 
-					//s.InfluenceBones[0] = 0;// aiS->InfluenceBones[0];// +boneOffset;
-					//meshS->InfluenceBones[0] = 0;
-					//s.InfluenceWeights[0] = 255;
-					//meshS->InfluenceWeights[0] = 255;
-
-					//s.InfluenceWeights[0] = aiS->InfluenceWeights[0];
-					//s.InfluenceWeights[1] = aiS->InfluenceWeights[1];
-
-
-					//aiNode *bone = mScenePtr->mRootNode->FindNode( mScenePtr->mMeshes[meshID]->mBones[0]->mName );
-				} // vertex loop
-
-				auto &aiM = mScenePtr->mMeshes[meshID];
 				TArray<int> bonemap;
-				bonemap.Add(0);
+				bonemap.SetNumZeroed(sec.BoneName.Num());
 				TArray<BoneMapOpt> boneAll;
 				{
 					BoneMapOpt o;
@@ -949,69 +1122,43 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 					o.weight = -1.f;
 					boneAll.Add(o);
 				}
-				//mScenePtr->mRootNode->mMeshes
-				for (uint32 boneIndex = 0; boneIndex < aiM->mNumBones; ++boneIndex) {
-					auto &aiB = aiM->mBones[boneIndex];
-
-					const int b = sk->RefSkeleton.FindBoneIndex(UTF8_TO_TCHAR(aiB->mName.C_Str()));
-
+				TArray<int> missing;
+				for (int slot = 1; slot < sec.BoneName.Num(); ++slot) {
+					const int b = sk->RefSkeleton.FindBoneIndex(sec.BoneName[slot]);
 					if (b < 0) {
+						missing.Add(slot);
 						continue;
 					}
-					for (uint32 weightIndex = 0; weightIndex < aiB->mNumWeights; ++weightIndex) {
-						auto &aiW = aiB->mWeights[weightIndex];
+					bonemap[slot] = b;
 
-						if (aiW.mWeight == 0.f) {
-							continue;
+					if (Options::Get().IsMobileBone()) {
+						auto p = boneAll.FindByPredicate([&](BoneMapOpt &o) {return o.boneIndex == b; });
+						if (p) {
+							p->weight += sec.BoneWeight[slot];
+						} else {
+							BoneMapOpt o;
+							o.boneIndex = b;
+							o.weight = sec.BoneWeight[slot];
+							boneAll.Add(o);
 						}
-						for (int jj = 0; jj < 8; ++jj) {
-							auto &s = Weight[aiW.mVertexId + currentVertex];
-							if (s.InfluenceWeights[jj] > 0) {
-								continue;
-							}
-
-							int tabledIndex = 0;
-							auto f = bonemap.Find(b);
-							if (f != INDEX_NONE) {
-								tabledIndex = f;
-							}
-							else {
-								if (Options::Get().IsDebugOneBone() == false) {
-									tabledIndex = bonemap.Add(b);
-								}
-							}
-							if (tabledIndex > 255) {
-								UE_LOG(LogTemp, Warning, TEXT("bonemap over!"));
-							}
-
-							if (Options::Get().IsDebugOneBone()) {
-								tabledIndex = 0;
-							}
-
-							const float ww = FMath::Clamp(aiW.mWeight, 0.f, 1.f);
-							s.InfluenceBones[jj] = tabledIndex;
-							//s.InfluenceWeights[jj] = (uint8)FMath::TruncToInt(ww * 255.f + (0.5f - KINDA_SMALL_NUMBER));
-							s.InfluenceWeights[jj] = (uint8)FMath::TruncToInt(ww * 255.f);
-
-							meshWeight[aiW.mVertexId].InfluenceBones[jj] = s.InfluenceBones[jj];
-							meshWeight[aiW.mVertexId].InfluenceWeights[jj] = s.InfluenceWeights[jj];
+					}
+				}
 
-							if (Options::Get().IsMobileBone()){
-								auto p = boneAll.FindByPredicate([&](BoneMapOpt &o) {return o.boneIndex == b; });
-								if (p) {
-									p->weight += aiW.mWeight;
-								} else {
-									BoneMapOpt o;
-									o.boneIndex = b;
-									o.weight = aiW.mWeight;
-									boneAll.Add(o);
-								}
+				if (missing.Num()) {
+					// not in the skeleton. drop the weight
+					int warnCount = 0;
+					for (int vi = 0; vi < sec.NumVertices; ++vi) {
+						auto &a = Weight[currentVertex + vi];
+						for (int i = 0; i < 8; ++i) {
+							if (missing.Contains(a.InfluenceBones[i])) {
+								a.InfluenceBones[i] = 0;
+								a.InfluenceWeights[i] = 0;
 							}
-
-							break;
 						}
+						NormalizeWeight(a, warnCount);
 					}
-				}// bone loop
+					bWeightChanged = true;
+				}
 
 				// mobile remap
 				if (Options::Get().IsMobileBone() && boneAll.Num() > 75) {
@@ -1048,31 +1195,14 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 						boneAll.RemoveAt(1);
 					}
 					if (mobileMap.Num()) {
-						for (auto &a : Weight) {
+						// this section only
+						for (int vi = 0; vi < sec.NumVertices; ++vi) {
+							auto &a = Weight[currentVertex + vi];
 							for (int i = 0; i < 8; ++i) {
 								auto &infBone = a.InfluenceBones[i];
 								auto &infWeight = a.InfluenceWeights[i];
 								if (bonemap.IsValidIndex(infBone) == false) {
-									infWeight = 0.f;
-									infBone = 0;
-									continue;
-								}
-								auto srcBoneIndex = bonemap[infBone];
-								auto f = mobileMap.Find(srcBoneIndex);
-								if (f) {
-									auto dstBoneIndex = *f;
-									infBone = bonemapNew.IndexOfByKey(dstBoneIndex);
-								} else {
-									infBone = bonemapNew.IndexOfByKey(srcBoneIndex);
-								}
-							}
-						}
-						for (auto &a : meshWeight) {
-							for (int i = 0; i < 8; ++i) {
-								auto &infBone = a.InfluenceBones[i];
-								auto &infWeight = a.InfluenceWeights[i];
-								if (bonemap.IsValidIndex(infBone) == false) {
-									infWeight = 0.f;
+									infWeight = 0;
 									infBone = 0;
 									continue;
 								}
@@ -1086,97 +1216,51 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 								}
 							}
 						}
+						bWeightChanged = true;
 					}
 					bonemap = bonemapNew;
 				}// mobile remap
 
 				if (VRMConverter::IsImportMode() == false) {
-					rd.RenderSections.SetNum(result.meshInfo.Num());
+					rd.RenderSections.SetNum(meshData->Sections.Num());
 
 					FSkelMeshRenderSection &NewRenderSection = rd.RenderSections[meshID];
-					//NewRenderSection = rd.RenderSections[0];
 
 					bool bUseMergeMaterial = Options::Get().IsMergeMaterial();
-					if ((int)aiM->mMaterialIndex >= vrmAssetList->MaterialMergeTable.Num()) {
+					if ((int)sec.MaterialIndex >= vrmAssetList->MaterialMergeTable.Num()) {
 						bUseMergeMaterial = false;
 					}
 					if (bUseMergeMaterial) {
-						NewRenderSection.MaterialIndex = vrmAssetList->MaterialMergeTable[aiM->mMaterialIndex];// ModelSection.MaterialIndex;
+						NewRenderSection.MaterialIndex = vrmAssetList->MaterialMergeTable[sec.MaterialIndex];
 					}else {
-						NewRenderSection.MaterialIndex = aiM->mMaterialIndex;// ModelSection.MaterialIndex;
+						NewRenderSection.MaterialIndex = sec.MaterialIndex;
 					}
 					if (NewRenderSection.MaterialIndex >= vrmAssetList->Materials.Num()) NewRenderSection.MaterialIndex = 0;
-					NewRenderSection.BaseIndex = currentIndex;
-					NewRenderSection.NumTriangles = result.meshInfo[meshID].Triangles.Num() / 3;
-					//NewRenderSection.bRecomputeTangent = ModelSection.bRecomputeTangent;
-					NewRenderSection.bCastShadow = true;// ModelSection.bCastShadow;
-					NewRenderSection.BaseVertexIndex = currentVertex;// currentVertex;// currentVertex;// ModelSection.BaseVertexIndex;
-															//NewRenderSection.ClothMappingData = ModelSection.ClothMappingData;
-															//NewRenderSection.BoneMap.SetNum(1);//ModelSection.BoneMap;
-															//NewRenderSection.BoneMap[0] = 10;
-					//NewRenderSection.BoneMap.SetNum(sk->Skeleton->GetBoneTree().Num());//ModelSection.BoneMap;
-					//for (int i = 0; i < NewRenderSection.BoneMap.Num(); ++i) {
-					//	NewRenderSection.BoneMap[i] = i;
-					//}
+					NewRenderSection.BaseIndex = sec.BaseIndex;
+					NewRenderSection.NumTriangles = sec.NumTriangles;
+					NewRenderSection.bCastShadow = true;
+					NewRenderSection.BaseVertexIndex = sec.BaseVertex;
 					if (bonemap.Num() > 0) {
-						NewRenderSection.BoneMap.SetNum(bonemap.Num());//ModelSection.BoneMap;
+						NewRenderSection.BoneMap.SetNum(bonemap.Num());
 						for (int i = 0; i < NewRenderSection.BoneMap.Num(); ++i) {
 							NewRenderSection.BoneMap[i] = bonemap[i];
 						}
 					}else {
 						NewRenderSection.BoneMap.SetNum(1);
-						auto *p = GetNodeFromMeshID(meshID, mScenePtr);
+						auto *p = GetNodeFromMeshID(sec.MeshID, mScenePtr);
 						int32 i = k->GetReferenceSkeleton().FindBoneIndex(UTF8_TO_TCHAR(p->mName.C_Str()));
 						if (i <= 0) {
-							i = meshID;
+							i = sec.MeshID;
 						}
 						NewRenderSection.BoneMap[0] = i;
 					}
 
+					NewRenderSection.NumVertices = sec.NumVertices;
 
-					NewRenderSection.NumVertices = result.meshInfo[meshID].Vertices.Num();// result.meshInfo[meshID].Triangles.Num();// allVertex;// result.meshInfo[meshID].Vertices.Num();// ModelSection.NumVertices;
-
-					NewRenderSection.MaxBoneInfluences = 4;// ModelSection.MaxBoneInfluences;
-															//NewRenderSection.CorrespondClothAssetIndex = ModelSection.CorrespondClothAssetIndex;
-															//NewRenderSection.ClothingData = ModelSection.ClothingData;
+					NewRenderSection.MaxBoneInfluences = 4;
 					TMap<int32, TArray<int32>> OverlappingVertices;
 					NewRenderSection.DuplicatedVerticesBuffer.Init(NewRenderSection.NumVertices, OverlappingVertices);
-					NewRenderSection.bDisabled = false;// ModelSection.bDisabled;
-														//RenderSections.Add(NewRenderSection);
-														//rd.RenderSections[0] = NewRenderSection;
-				}
-
-
-				// normalize weight
-				for (auto &w : meshWeight) {
-					static int warnCount = 0;
-					if (&w == &meshWeight[0]) {
-						warnCount = 0;
-					}
-					int f = 0;
-					int maxIndex = 0;
-					int maxWeight = 0;
-					for (int i = 0; i < 8; ++i) {
-						f += w.InfluenceWeights[i];
-
-						if (maxWeight < w.InfluenceWeights[i]) {
-							maxWeight = w.InfluenceWeights[i];
-							maxIndex = i;
-						}
-					}
-					if (f > 255) {
-						UE_LOG(LogTemp, Warning, TEXT("overr"));
-						w.InfluenceWeights[0] -= (uint8)(f - 255);
-					}
-					if (f <= 254) {
-						if (f <= (255-8)) {
-							if (warnCount < 50) {
-								UE_LOG(LogTemp, Warning, TEXT("less"));
-								warnCount++;
-							}
-						}
-						w.InfluenceWeights[maxIndex] += (uint8)(255 - f);
-					}
+					NewRenderSection.bDisabled = false;
 				}
 
 #if WITH_EDITORONLY_DATA
@@ -1184,55 +1268,41 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 					auto &s = sk->GetImportedModel()->LODModels[0].Sections[meshID];
 					s.MaterialIndex = 0;
 
-					TMap<int32, TArray<int32>> OverlappingVertices;
-
 					{
 						bool bUseMergeMaterial = Options::Get().IsMergeMaterial();
-						if ((int)aiM->mMaterialIndex >= vrmAssetList->MaterialMergeTable.Num()) {
+						if ((int)sec.MaterialIndex >= vrmAssetList->MaterialMergeTable.Num()) {
 							bUseMergeMaterial = false;
 						}
 						if (bUseMergeMaterial) {
-							s.MaterialIndex = vrmAssetList->MaterialMergeTable[aiM->mMaterialIndex];
+							s.MaterialIndex = vrmAssetList->MaterialMergeTable[sec.MaterialIndex];
 						} else {
-							s.MaterialIndex = aiM->mMaterialIndex;
+							s.MaterialIndex = sec.MaterialIndex;
 						}
 					}
 
 					if (s.MaterialIndex >= vrmAssetList->Materials.Num()) s.MaterialIndex = 0;
-					s.BaseIndex = currentIndex;
-					s.NumTriangles = result.meshInfo[meshID].Triangles.Num() / 3;
-					s.BaseVertexIndex = currentVertex;
-					s.SoftVertices = meshWeight;
+					s.BaseIndex = sec.BaseIndex;
+					s.NumTriangles = sec.NumTriangles;
+					s.BaseVertexIndex = sec.BaseVertex;
+					s.SoftVertices.Append(Weight.GetData() + currentVertex, sec.NumVertices);
 					if (bonemap.Num() > 0) {
-						s.BoneMap.SetNum(bonemap.Num());//ModelSection.BoneMap;
+						s.BoneMap.SetNum(bonemap.Num());
 						for (int i = 0; i < s.BoneMap.Num(); ++i) {
 							s.BoneMap[i] = bonemap[i];
 						}
 					}else {
 						s.BoneMap.SetNum(1);
-						auto *p = GetNodeFromMeshID(meshID, mScenePtr);
+						auto *p = GetNodeFromMeshID(sec.MeshID, mScenePtr);
 						int32 i = k->GetReferenceSkeleton().FindBoneIndex(UTF8_TO_TCHAR(p->mName.C_Str()));
 						if (i <= 0) {
-							i = meshID;
+							i = sec.MeshID;
 						}
 						s.BoneMap[0] = i;
 					}
-					s.NumVertices = meshWeight.Num();
+					s.NumVertices = sec.NumVertices;
 					s.MaxBoneInfluences = 4;
 				}
 #endif
-
-				//rd.MultiSizeIndexContainer.CopyIndexBuffer(result.meshInfo[0].Triangles);
-				int t1 = Triangles.Num();
-				Triangles.Append(result.meshInfo[meshID].Triangles);
-				int t2 = Triangles.Num();
-
-				for (int i = t1; i < t2; ++i) {
-					Triangles[i] += currentVertex;
-				}
-				currentIndex += result.meshInfo[meshID].Triangles.Num();
-				currentVertex += result.meshInfo[meshID].Vertices.Num();
-				//rd.MultiSizeIndexContainer.update
 			} // mesh loop
 
 			if (Options::Get().IsMergePrimitive()) {
@@ -1297,96 +1367,23 @@ bool VRMConverter::ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene
 #endif
 			} // merge primitive
 
-			if (1) {
-				int warnCount = 0;
-				for (auto &w : Weight) {
-					int f = 0;
-					int maxIndex = 0;
-					int maxWeight = 0;
-					for (int i = 0; i < 8; ++i) {
-						f += w.InfluenceWeights[i];
-
-						if (maxWeight < w.InfluenceWeights[i]) {
-							maxWeight = w.InfluenceWeights[i];
-							maxIndex = i;
-						}
-					}
-					if (f > 255) {
-						UE_LOG(LogTemp, Warning, TEXT("overr"));
-						w.InfluenceWeights[0] -= (uint8)(f - 255);
-					}
-					if (f <= 254) {
-						if (f <= (255 - 8)) {
-							if (warnCount < 50) {
-								UE_LOG(LogTemp, Warning, TEXT("less"));
-								warnCount++;
-							}
-						}
-						w.InfluenceWeights[maxIndex] += (uint8)(255 - f);
-					}
-				}
-			}
-
 #if WITH_EDITOR
 			{
 				FSkeletalMeshLODModel *p = &(sk->GetImportedModel()->LODModels[0]);
 				p->NumVertices = allVertex;
 				p->NumTexCoords = 1;// allVertex;
-				p->IndexBuffer = Triangles;
+				p->IndexBuffer = meshData->Triangles;
 				p->ActiveBoneIndices = rd.ActiveBoneIndices;
 				p->RequiredBones = rd.RequiredBones;
 			}
 #endif
 			//rd.StaticVertexBuffers.StaticMeshVertexBuffer.TexcoordDataPtr;
 
-			if (VRMConverter::IsImportMode() == false) {
-				ENQUEUE_RENDER_COMMAND(UpdateCommand)(
-					[sk, Triangles, Weight](FRHICommandListImmediate& RHICmdList)
-				{
-					FSkeletalMeshLODRenderData &d = sk->GetResourceForRendering()->LODRenderData[0];
-
-					if (d.MultiSizeIndexContainer.IsIndexBufferValid()) {
-						d.MultiSizeIndexContainer.GetIndexBuffer()->ReleaseResource();
-					}
-					d.MultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), Triangles);
-					d.MultiSizeIndexContainer.GetIndexBuffer()->InitResource();
-
-					//d.AdjacencyMultiSizeIndexContainer.CopyIndexBuffer(Triangles);
-					if (d.AdjacencyMultiSizeIndexContainer.IsIndexBufferValid()) {
-						d.AdjacencyMultiSizeIndexContainer.GetIndexBuffer()->ReleaseResource();
-					}
-					d.AdjacencyMultiSizeIndexContainer.RebuildIndexBuffer(sizeof(uint32), Triangles);
-					d.AdjacencyMultiSizeIndexContainer.GetIndexBuffer()->InitResource();
-
-#if WITH_EDITOR
-					d.SkinWeightVertexBuffer.Init(Weight);
-#else
-					{
-						TArray< TSkinWeightInfo<false> > InWeights;
-						InWeights.Reserve(Weight.Num());
-
-						for (const auto &a : Weight) {
-							auto n = new(InWeights) TSkinWeightInfo<false>;
-
-							memcpy(n->InfluenceBones, a.InfluenceBones, sizeof(n->InfluenceBones));
-							memcpy(n->InfluenceWeights, a.InfluenceWeights, sizeof(n->InfluenceWeights));
-						}
-						d.SkinWeightVertexBuffer = InWeights;
-					}
-#endif
-					d.SkinWeightVertexBuffer.InitResource();
-
-					d.StaticVertexBuffers.PositionVertexBuffer.UpdateRHI();
-					d.StaticVertexBuffers.StaticMeshVertexBuffer.UpdateRHI();
-
-					d.MultiSizeIndexContainer.GetIndexBuffer()->UpdateRHI();
-					d.AdjacencyMultiSizeIndexContainer.GetIndexBuffer()->UpdateRHI();
-					d.SkinWeightVertexBuffer.UpdateRHI();
-
-					//src->GetResourceForRendering()->LODRenderData[0].rhi
-					//v.PositionVertexBuffer.UpdateRHI();
-				});
+			// the bones moved. the skin weights again
+			if (VRMConverter::IsImportMode() == false && bWeightChanged) {
+				InitSkinWeight(rd, Weight);
 			}
+			sk->InitResources();
 		}
 		{
 
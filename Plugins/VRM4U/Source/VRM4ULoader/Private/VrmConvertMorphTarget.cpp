@@ -2,6 +2,7 @@
 
 #include "VrmConvertMorphTarget.h"
 #include "VrmConvert.h"
+#include "VrmConvertMeshData.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -28,7 +29,7 @@
 #include "Async/ParallelFor.h"
 
 
-static bool readMorph2(TArray<FMorphTargetDelta> &MorphDeltas, aiString targetName,const aiScene *mScenePtr, const UVrmAssetListObject *assetList) {
+static bool readMorph2(TArray<FMorphTargetDelta> &MorphDeltas, aiString targetName,const aiScene *mScenePtr, const FReturnedData &result, bool bIncludeNormal) {
 
 	//return readMorph33(MorphDeltas, targetName, mScenePtr);
 
@@ -41,7 +42,7 @@ static bool readMorph2(TArray<FMorphTargetDelta> &MorphDeltas, aiString targetNa
 	morphinit.TangentZDelta = FVector::ZeroVector;
 
 	for (uint32_t m = 0; m < mScenePtr->mNumMeshes; ++m) {
-		const auto &mesh = assetList->MeshReturnedData->meshInfo[m];
+		const auto &mesh = result.meshInfo[m];
 
 		const aiMesh &aiM = *(mScenePtr->mMeshes[m]);
 
@@ -58,8 +59,6 @@ static bool readMorph2(TArray<FMorphTargetDelta> &MorphDeltas, aiString targetNa
 			TArray<FMorphTargetDelta> tmpData;
 			tmpData.SetNumZeroed(aiA.mNumVertices);
 
-			bool bIncludeNormal = VRMConverter::Options::Get().IsEnableMorphTargetNormal();
-
 			uint32_t vertexCount = 0;
 			for (uint32_t i = 0; i < aiA.mNumVertices; ++i) {
 
@@ -100,61 +99,64 @@ static bool readMorph2(TArray<FMorphTargetDelta> &MorphDeltas, aiString targetNa
 }
 
 
-bool VRMConverter::ConvertMorphTarget(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr) {
+void VRMConverter::BuildMorphData(const aiScene *mScenePtr, const VRMParseOption &option, VRMMeshData &meshData) {
+	meshData.Morphs.Reset();
 #if WITH_EDITOR
-	if (Options::Get().IsSkipMorphTarget()) {
-		return true;
+	if (mScenePtr == nullptr || meshData.MeshInfo.IsValid() == false) {
+		return;
 	}
 
-	USkeletalMesh *sk = vrmAssetList->SkeletalMesh;
-
-	{
-		///sk->MarkPackageDirty();
-		// need to refresh the map
-		//sk->InitMorphTargets();
-		// invalidate render data
-		//sk->InvalidateRenderData();
-		//return true;
-	}
-
-	TArray<FSoftSkinVertex> sVertex;
-	sk->GetImportedModel()->LODModels[0].GetVertices(sVertex);
-	//mScenePtr->mMeshes[0]->mAnimMeshes[0]->mWeight
-
-	TArray<FString> MorphNameList;
-
-	TArray<UMorphTarget*> MorphTargetList;
-
 	for (uint32_t m = 0; m < mScenePtr->mNumMeshes; ++m) {
 		const aiMesh &aiM = *(mScenePtr->mMeshes[m]);
 		for (uint32_t a = 0; a < aiM.mNumAnimMeshes; ++a) {
 			const aiAnimMesh &aiA = *(aiM.mAnimMeshes[a]);
-			//aiA.
-			TArray<FMorphTargetDelta> MorphDeltas;
 
 			FString morphName = UTF8_TO_TCHAR(aiA.mName.C_Str());
-			if (morphName == TEXT("")) {
-				//morphName = FString::Printf("%d_%d", m, a);
+			if (meshData.Morphs.FindByPredicate([&](const VRMMeshData::Morph &o) {return o.Name == morphName; })) {
+				continue;
 			}
+			VRMMeshData::Morph &morph = meshData.Morphs[meshData.Morphs.AddDefaulted()];
+			morph.Name = morphName;
+		}
+	}
 
+	// one target per task, each reads all meshes
+	ParallelFor(meshData.Morphs.Num(), [&](int32 i) {
+		auto &morph = meshData.Morphs[i];
+		readMorph2(morph.Deltas, aiString(TCHAR_TO_UTF8(*morph.Name)), mScenePtr, *meshData.MeshInfo, option.bMorphTargetNormal);
+	});
+#endif
+}
 
-			if (MorphNameList.Find(morphName) != INDEX_NONE) {
-				continue;
-			}
-			MorphNameList.Add(morphName);
-			if (readMorph2(MorphDeltas, aiA.mName, mScenePtr, vrmAssetList) == false) {
-				continue;
-			}
+bool VRMConverter::ConvertMorphTarget(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, const VRMMeshData *meshData) {
+#if WITH_EDITOR
+	if (Options::Get().IsSkipMorphTarget()) {
+		return true;
+	}
+
+	VRMMeshData localMeshData;
+	if (meshData == nullptr) {
+		localMeshData.MeshInfo = vrmAssetList->MeshReturnedData;
+		BuildMorphData(mScenePtr, Options::Get().GetParseOption(), localMeshData);
+		meshData = &localMeshData;
+	}
 
-			//FString sss = FString::Printf(TEXT("%02d_%02d_"), m, a) + FString(aiA.mName.C_Str());
-			FString sss = morphName;// FString::Printf(TEXT("%02d_%02d_"), m, a) + FString();
-			UMorphTarget *mt = NewObject<UMorphTarget>(sk, *sss);
+	USkeletalMesh *sk = vrmAssetList->SkeletalMesh;
 
-			mt->PopulateDeltas(MorphDeltas, 0, sk->GetImportedModel()->LODModels[0].Sections);
+	TArray<UMorphTarget*> MorphTargetList;
 
-			if (mt->HasValidData()) {
-				MorphTargetList.Add(mt);
-			}
+	// deltas are built by BuildMorphData
+	for (const auto &morph : meshData->Morphs) {
+		if (morph.Deltas.Num() == 0) {
+			continue;
+		}
+
+		UMorphTarget *mt = NewObject<UMorphTarget>(sk, *morph.Name);
+
+		mt->PopulateDeltas(morph.Deltas, 0, sk->GetImportedModel()->LODModels[0].Sections);
+
+		if (mt->HasValidData()) {
+			MorphTargetList.Add(mt);
 		}
 	}
 	for (int i=0; i<MorphTargetList.Num(); ++i){
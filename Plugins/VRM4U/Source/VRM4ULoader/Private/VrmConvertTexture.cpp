@@ -589,7 +589,70 @@ UTexture2D* VRMConverter::CreateTexture(int32 InSizeX, int32 InSizeY, FString na
 }
 
 
-bool VRMConverter::ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr) {
+bool VRMConverter::DecodeTexture(const uint8 *data, int32 size, VRMDecodedTexture &out) {
+	out.Width = out.Height = 0;
+	out.BGRA.Reset();
+
+	if (data == nullptr || size < 2) {
+		return false;
+	}
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::GetModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+	// png, or jpeg by its SOI marker
+	const EImageFormat format = (data[0] == 0xFF && data[1] == 0xD8) ? EImageFormat::JPEG : EImageFormat::PNG;
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(format);
+	if (ImageWrapper.IsValid() == false || ImageWrapper->SetCompressed(data, size) == false) {
+		return false;
+	}
+	const TArray<uint8>* RawData = nullptr;
+	if (ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawData) == false || RawData == nullptr) {
+		return false;
+	}
+	out.Width = ImageWrapper->GetWidth();
+	out.Height = ImageWrapper->GetHeight();
+	out.BGRA = *RawData;
+	return out.Width > 0 && out.Height > 0;
+}
+
+bool VRMConverter::DecodeTexture(const aiTexture &t, VRMDecodedTexture &out) {
+	out.Width = out.Height = 0;
+	out.BGRA.Reset();
+
+	if (t.mHeight == 0) {
+		// compressed
+		return DecodeTexture((const uint8*)t.pcData, t.mWidth, out);
+	}
+
+	out.Width = t.mWidth;
+	out.Height = t.mHeight;
+	out.BGRA.SetNumUninitialized(out.Width * out.Height * sizeof(FColor));
+	for (int32 y = 0; y < out.Height; y++)
+	{
+		const aiTexel *c = &(t.pcData[y*out.Width]);
+		uint8* DestPtr = &out.BGRA[y * out.Width * sizeof(FColor)];
+		for (int32 x = 0; x < out.Width; x++)
+		{
+			*DestPtr++ = c->b;
+			*DestPtr++ = c->g;
+			*DestPtr++ = c->r;
+			*DestPtr++ = c->a;
+			c++;
+		}
+	}
+	return true;
+}
+
+void VRMConverter::DecodeTextures(const aiScene *mScenePtr, TArray<VRMDecodedTexture> &out) {
+	out.Reset();
+	if (mScenePtr == nullptr) {
+		return;
+	}
+	out.SetNum(mScenePtr->mNumTextures);
+	ParallelFor(out.Num(), [&](int32 i) {
+		DecodeTexture(*mScenePtr->mTextures[i], out[i]);
+	});
+}
+
+bool VRMConverter::ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, const TArray<VRMDecodedTexture> *decoded) {
 	if (vrmAssetList == nullptr || mScenePtr == nullptr) {
 		return false;
 	}
@@ -618,30 +681,23 @@ bool VRMConverter::ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList,
 	TArray<UTexture2D*> texArray;
 	texArray.Reserve(mScenePtr->mNumTextures);
 	if (mScenePtr->HasTextures()) {
-		IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
-		TSharedPtr<IImageWrapper> ImageWrapper;
-		// Note: PNG format.  Other formats are supported
-		ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
 
 		for (uint32_t i = 0; i < mScenePtr->mNumTextures; ++i) {
 			auto &t = *mScenePtr->mTextures[i];
-			int Width = t.mWidth;
-			int Height = t.mHeight;
-			const TArray<uint8>* RawData = nullptr;
-
-			if (Height == 0) {
-				if (ImageWrapper->SetCompressed(t.pcData, t.mWidth)) {
-
-				}
-				Width = ImageWrapper->GetWidth();
-				Height = ImageWrapper->GetHeight();
-
-				if (Width == 0 || Height == 0) {
-					continue;
-				}
 
-				ImageWrapper->GetRaw(ERGBFormat::BGRA, 8, RawData);
+			VRMDecodedTexture localDecoded;
+			const VRMDecodedTexture *d = (decoded && decoded->IsValidIndex(i)) ? &(*decoded)[i] : nullptr;
+			if (d == nullptr) {
+				DecodeTexture(t, localDecoded);
+				d = &localDecoded;
 			}
+			const int Width = d->Width;
+			const int Height = d->Height;
+			if (Width == 0 || Height == 0) {
+				continue;
+			}
+
 			FString baseName = NormalizeFileName(t.mFilename.C_Str());
 			if (baseName.Len() == 0) {
 				baseName = FString::FromInt(i);
@@ -656,24 +712,7 @@ bool VRMConverter::ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList,
 
 			// Fill in the base mip for the texture we created
 			uint8* MipData = (uint8*)NewTexture2D->PlatformData->Mips[0].BulkData.Lock(LOCK_READ_WRITE);
-			if (RawData) {
-				FMemory::Memcpy(MipData, RawData->GetData(), RawData->Num());
-			}
-			else {
-				for (int32 y = 0; y < Height; y++)
-				{
-					const aiTexel *c = &(t.pcData[y*Width]);
-					uint8* DestPtr = &MipData[y * Width * sizeof(FColor)];
-					for (int32 x = 0; x < Width; x++)
-					{
-						*DestPtr++ = c->b;
-						*DestPtr++ = c->g;
-						*DestPtr++ = c->r;
-						*DestPtr++ = c->a;
-						c++;
-					}
-				}
-			}
+			FMemory::Memcpy(MipData, d->BGRA.GetData(), d->BGRA.Num());
 			NewTexture2D->PlatformData->Mips[0].BulkData.Unlock();
 
 			// Set options
@@ -690,7 +729,7 @@ bool VRMConverter::ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList,
 			NewTexture2D->CompressionNone = false;
 			NewTexture2D->DeferCompression = true;
 			NewTexture2D->MipGenSettings = TMGS_NoMipmaps;
-			NewTexture2D->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, RawData->GetData());
+			NewTexture2D->Source.Init(Width, Height, 1, 1, ETextureSourceFormat::TSF_BGRA8, d->BGRA.GetData());
 			//NewTexture2D->Source.Compress();
 #endif
 
@@ -8,11 +8,15 @@
 #include "LoaderBPFunctionLibrary.h"
 
 #include "Misc/CoreDelegates.h"
+#include "Async/Async.h"
 
 
 UVrmLoaderComponent::UVrmLoaderComponent(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
+	// ticks only while loading
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
 }
 
 void UVrmLoaderComponent::OnRegister()
@@ -25,6 +29,8 @@ void UVrmLoaderComponent::OnRegister()
 
 void UVrmLoaderComponent::OnUnregister()
 {
+	CancelLoadVRMFileAsync();
+
 	Super::OnUnregister();
 
 	//StaticOnDropFilesDelegate.RemoveAll(this);
@@ -39,17 +45,60 @@ bool UVrmLoaderComponent::LoadVRMFile(const UVrmAssetListObject *InVrmAsset, UVr
 }
 
 bool UVrmLoaderComponent::LoadVRMFileAsync(const UVrmAssetListObject *InVrmAsset, FString filepath) {
+	CancelLoadVRMFileAsync();
+	if (InVrmAsset == nullptr) {
+		return false;
+	}
+
+	LoadTask = MakeShareable(new FVrmLoadTask(InVrmAsset, filepath));
+
+	// the parse data only. the task stays on the game thread
+	TSharedPtr<FVrmParseData, ESPMode::ThreadSafe> data = LoadTask->GetParseData();
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [data]() {
+		data->Parse();
+	});
 
-	ULoaderBPFunctionLibrary::LoadVRMFile(InVrmAsset, AssetList, filepath);
-	bResultQueue = true;
+	SetComponentTickEnabled(true);
 	return true;
 }
 
+void UVrmLoaderComponent::CancelLoadVRMFileAsync() {
+	if (LoadTask.IsValid()) {
+		LoadTask->Cancel();
+		LoadTask.Reset();
+	}
+}
+
+bool UVrmLoaderComponent::IsLoadingVRMFile() const {
+	return LoadTask.IsValid();
+}
+
+float UVrmLoaderComponent::GetLoadProgress() const {
+	return LoadTask.IsValid() ? LoadTask->GetProgress() : 0.f;
+}
+
 void UVrmLoaderComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
-	if (bResultQueue) {
-		bResultQueue = false;
+	if (LoadTask.IsValid() == false) {
+		SetComponentTickEnabled(false);
+		return;
+	}
+	if (LoadTask->GetParseData()->bDone == false) {
+		return;
+	}
+
+	// at least one stage per frame
+	const double StartTime = FPlatformTime::Seconds();
+	bool bContinue = true;
+	do {
+		bContinue = LoadTask->FinalizeStep();
+	} while (bContinue && (FPlatformTime::Seconds() - StartTime) * 1000.0 < FinalizeBudgetMs);
+
+	if (bContinue == false) {
+		AssetList = LoadTask->GetResult();
+		LoadTask.Reset();
+		SetComponentTickEnabled(false);
 		OnFinishLoad.Broadcast(AssetList);
 	}
 }
@@ -0,0 +1,115 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#include "VrmMappedIOSystem.h"
+
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/EngineVersionComparison.h"
+#if	UE_VERSION_OLDER_THAN(4,20,0)
+#else
+#include "Async/MappedFileHandle.h"
+#endif
+
+VRMMappedIOStream::VRMMappedIOStream() {
+}
+
+VRMMappedIOStream::~VRMMappedIOStream() {
+}
+
+VRMMappedIOStream *VRMMappedIOStream::Open(const FString &filepath) {
+	TUniquePtr<VRMMappedIOStream> s(new VRMMappedIOStream());
+
+#if	UE_VERSION_OLDER_THAN(4,20,0)
+	// no mapped file api. read once
+	{
+#else
+	s->Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*filepath));
+	if (s->Handle.IsValid()) {
+		s->Region.Reset(s->Handle->MapRegion());
+	}
+	if (s->Region.IsValid()) {
+		s->Data = s->Region->GetMappedPtr();
+		s->Size = (size_t)s->Region->GetMappedSize();
+	} else {
+		s->Handle.Reset();
+#endif
+		if (FFileHelper::LoadFileToArray(s->Fallback, *filepath, FILEREAD_Silent) == false) {
+			return nullptr;
+		}
+		s->Data = s->Fallback.GetData();
+		s->Size = (size_t)s->Fallback.Num();
+	}
+	return s.Release();
+}
+
+size_t VRMMappedIOStream::Read(void* pvBuffer, size_t pSize, size_t pCount) {
+	if (pSize == 0 || Pos >= Size) {
+		return 0;
+	}
+	const size_t count = FMath::Min(pCount, (Size - Pos) / pSize);
+	FMemory::Memcpy(pvBuffer, Data + Pos, count * pSize);
+	Pos += count * pSize;
+	return count;
+}
+
+size_t VRMMappedIOStream::Write(const void* pvBuffer, size_t pSize, size_t pCount) {
+	return 0;
+}
+
+aiReturn VRMMappedIOStream::Seek(size_t pOffset, aiOrigin pOrigin) {
+	size_t p = 0;
+	switch (pOrigin) {
+	case aiOrigin_SET:
+		p = pOffset;
+		break;
+	case aiOrigin_CUR:
+		p = Pos + pOffset;
+		break;
+	case aiOrigin_END:
+		if (pOffset > Size) {
+			return aiReturn_FAILURE;
+		}
+		p = Size - pOffset;
+		break;
+	default:
+		return aiReturn_FAILURE;
+	}
+	if (p > Size) {
+		return aiReturn_FAILURE;
+	}
+	Pos = p;
+	return aiReturn_SUCCESS;
+}
+
+size_t VRMMappedIOStream::Tell() const {
+	return Pos;
+}
+
+size_t VRMMappedIOStream::FileSize() const {
+	return Size;
+}
+
+void VRMMappedIOStream::Flush() {
+}
+
+////
+
+bool VRMMappedIOSystem::Exists(const char* pFile) const {
+	return FPaths::FileExists(UTF8_TO_TCHAR(pFile));
+}
+
+char VRMMappedIOSystem::getOsSeparator() const {
+	return '/';
+}
+
+Assimp::IOStream* VRMMappedIOSystem::Open(const char* pFile, const char* pMode) {
+	if (pMode && (FCStringAnsi::Strchr(pMode, 'w') || FCStringAnsi::Strchr(pMode, 'a'))) {
+		return nullptr;
+	}
+	return VRMMappedIOStream::Open(UTF8_TO_TCHAR(pFile));
+}
+
+void VRMMappedIOSystem::Close(Assimp::IOStream* pFile) {
+	delete pFile;
+}
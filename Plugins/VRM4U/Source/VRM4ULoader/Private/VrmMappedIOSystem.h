@@ -0,0 +1,51 @@
+// VRM4U Copyright (c) 2019 Haruyoshi Yamamoto. This software is released under the MIT License.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/EngineVersionComparison.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// read only stream on a memory mapped file.
+// falls back to a single read into memory where the platform (or a pak, or 4.19) cannot map
+class VRMMappedIOStream : public Assimp::IOStream {
+public:
+	static VRMMappedIOStream *Open(const FString &filepath);
+	virtual ~VRMMappedIOStream();
+
+	virtual size_t Read(void* pvBuffer, size_t pSize, size_t pCount) override;
+	virtual size_t Write(const void* pvBuffer, size_t pSize, size_t pCount) override;
+	virtual aiReturn Seek(size_t pOffset, aiOrigin pOrigin) override;
+	virtual size_t Tell() const override;
+	virtual size_t FileSize() const override;
+	virtual void Flush() override;
+
+private:
+	VRMMappedIOStream();
+
+#if	UE_VERSION_OLDER_THAN(4,20,0)
+#else
+	// region is released before the handle
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+#endif
+	TArray<uint8> Fallback;
+
+	const uint8 *Data = nullptr;
+	size_t Size = 0;
+	size_t Pos = 0;
+};
+
+// paths are utf8. the importer takes ownership (SetIOHandler)
+class VRMMappedIOSystem : public Assimp::IOSystem {
+public:
+	virtual bool Exists(const char* pFile) const override;
+	virtual char getOsSeparator() const override;
+	virtual Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override;
+	virtual void Close(Assimp::IOStream* pFile) override;
+};
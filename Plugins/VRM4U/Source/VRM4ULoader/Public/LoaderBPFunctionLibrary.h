@@ -3,9 +3,15 @@
 #pragma once
 #include "ProceduralMeshComponent.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "UObject/GCObject.h"
+#include "HAL/ThreadSafeBool.h"
 #include "VrmConvert.h"
 #include "LoaderBPFunctionLibrary.generated.h"
 
+namespace Assimp {
+	class Importer;
+}
+
 UENUM(BlueprintType)
 enum class EPathType : uint8
 {
@@ -72,6 +78,71 @@ struct FReturnedData
 
 
 
+// file read, assimp parse, mesh buffers and texture decode. pure data, any thread
+struct VRM4ULOADER_API FVrmParseData {
+	// InOption: read on the game thread
+	FVrmParseData(const FString &InFilepath, const VRMConverter::VRMParseOption &InOption);
+	~FVrmParseData();
+
+	bool Parse();
+
+	FString filepath;
+	bool bVRMModel = true;
+	VRMConverter::VRMParseOption option;
+	TUniquePtr<Assimp::Importer> importer;
+	const aiScene *mScenePtr = nullptr;
+	bool bBoneName = false;
+	TSharedPtr<VRMConverter::VRMMeshData, ESPMode::ThreadSafe> meshData;
+	TArray<VRMConverter::VRMDecodedTexture> decodedTexture;
+
+	FThreadSafeBool bCancel;
+	FThreadSafeBool bDone;
+};
+
+// VRM load in stages. ULoaderBPFunctionLibrary::LoadVRMFile runs them in a row,
+// UVrmLoaderComponent parses on a worker thread and spreads the rest over frames
+class VRM4ULOADER_API FVrmLoadTask : public FGCObject {
+public:
+	// game thread
+	FVrmLoadTask(const class UVrmAssetListObject *InVrmAsset, const FString &InFilepath);
+	virtual ~FVrmLoadTask();
+
+	// shared with the worker thread. outlives the task when canceled
+	const TSharedPtr<FVrmParseData, ESPMode::ThreadSafe> &GetParseData() const {
+		return ParseData;
+	}
+
+	// game thread, after the parse. one stage per call. false when finished, see IsSuccess
+	bool FinalizeStep();
+
+	void Cancel();
+	bool IsSuccess() const {
+		return bSuccess;
+	}
+	// 0-1
+	float GetProgress() const;
+	class UVrmAssetListObject *GetResult() const {
+		return bSuccess ? out : nullptr;
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+private:
+	TSharedPtr<FVrmParseData, ESPMode::ThreadSafe> ParseData;
+
+	const class UVrmAssetListObject *InVrmAsset = nullptr;
+	class UVrmAssetListObject *out = nullptr;
+
+	// the last one saves
+	static const int32 FinalizeStepNum = 8;
+
+	int32 step = 0;
+	bool bFinished = false;
+	bool bSuccess = false;
+	bool bConvertResult = true;
+	double StartTime = 0;
+};
+
 /**
  * 
  */
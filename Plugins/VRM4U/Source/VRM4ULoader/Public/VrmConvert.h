@@ -12,6 +12,7 @@
  */
 
 struct aiScene;
+struct aiTexture;
 class UTexture2D;
 class UMaterialInterface;
 class USkeletalMesh;
@@ -31,6 +32,15 @@ enum EVRMImportMaterialType
 	VRMIMT_MAX,
 };
 
+UENUM(BlueprintType)
+enum EVRMImportProcessType
+{
+	VRMIPT_Fast			UMETA(DisplayName="Fast(tangent for normal mapped mesh only)"),
+	VRMIPT_Full			UMETA(DisplayName="Full(tangent for all mesh)"),
+
+	VRMIPT_MAX,
+};
+
 
 class VRM4ULOADER_API VRMConverter {
 public:
@@ -41,14 +51,51 @@ public:
 
 	static bool NormalizeBoneName(const aiScene *mScenePtr);
 
+	// embedded texture as BGRA8. pure data, no UObject
+	struct VRMDecodedTexture {
+		int32 Width = 0;
+		int32 Height = 0;
+		TArray<uint8> BGRA;
+	};
+	// any thread. the ImageWrapper module must be loaded
+	static bool DecodeTexture(const aiTexture &t, VRMDecodedTexture &out);
+	// png or jpeg
+	static bool DecodeTexture(const uint8 *data, int32 size, VRMDecodedTexture &out);
+	static void DecodeTextures(const aiScene *mScenePtr, TArray<VRMDecodedTexture> &out);
+
 	static UTexture2D* CreateTexture(int32 InSizeX, int32 InSizeY, FString name, UPackage *package);
-	static bool ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
+	// decoded: from DecodeTextures. decoded here when null
+	static bool ConvertTextureAndMaterial(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, const TArray<VRMDecodedTexture> *decoded = nullptr);
+
+	// options the parse thread needs. read on the game thread, the getters are backed by the import window
+	struct VRMParseOption {
+		unsigned int AssimpProcessFlags = 0;
+		EVRMImportProcessType ProcessType = EVRMImportProcessType::VRMIPT_Fast;
+		bool bVRMModel = true;
+		bool bImportMode = false;
+		bool bOptimizeVertex = true;
+		bool bDebugOneBone = false;
+		float ModelScale = 1.f;
+		bool bMorphTarget = true;
+		bool bMorphTargetNormal = false;
+	};
 
-	static bool ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
+	// mesh buffers and morph deltas. pure data, any thread. see VrmConvertMeshData.h
+	struct VRMMeshData;
+	static TSharedPtr<VRMMeshData, ESPMode::ThreadSafe> BuildMeshData(const aiScene *mScenePtr, const VRMParseOption &option);
+	// after BuildMeshData. editor only, empty otherwise
+	static void BuildMorphData(const aiScene *mScenePtr, const VRMParseOption &option, VRMMeshData &meshData);
 
-	static bool ConvertMorphTarget(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
+	// meshData: from BuildMeshData, the render data is moved to the mesh. built here when null
+	static bool ConvertModel(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, VRMMeshData *meshData = nullptr);
+
+	// meshData: from BuildMorphData. built here when null
+	static bool ConvertMorphTarget(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr, const VRMMeshData *meshData = nullptr);
 
 	static UVrmLicenseObject *GetVRMMeta(const aiScene *mScenePtr);
+	// glb header and json chunk, plus the thumbnail image only. no assimp.
+	// nullptr when the file is not a glb
+	static UVrmLicenseObject *GetVRMMetaFromGLB(const FString &filepath, int32 thumbnailSize = 256);
 	static bool ConvertVrmMeta(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
 	static bool ConvertHumanoid(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
 	static bool ConvertRig(UVrmAssetListObject *vrmAssetList, const aiScene *mScenePtr);
@@ -102,6 +149,13 @@ public:
 
 		EVRMImportMaterialType GetMaterialType() const;
 		void SetMaterialType(EVRMImportMaterialType type);
+
+		EVRMImportProcessType GetProcessType() const;
+		void SetProcessType(EVRMImportProcessType type);
+		// assimp post process flags for the process type
+		unsigned int GetAssimpProcessFlags() const;
+		// game thread
+		VRMParseOption GetParseOption() const;
 	};
 
 	struct VRMBoneTable {
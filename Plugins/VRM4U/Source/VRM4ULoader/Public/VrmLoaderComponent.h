@@ -28,6 +28,7 @@ enum class ETemperatureSeverityType : uint8
 //static_assert((int)ETemperatureSeverityType::NumSeverities == (int)FCoreDelegates::ETemperatureSeverity::NumSeverities, "TemperatureSeverity enums are out of sync");
 
 class UVrmAssetListObject;
+class FVrmLoadTask;
 
 /** Component to handle receiving notifications from the OS about application state (activated, suspended, termination, etc). */
 UCLASS(ClassGroup=Utility, HideCategories=(Activation, "Components|Activation", Collision), meta=(BlueprintSpawnableComponent))
@@ -49,7 +50,10 @@ class VRM4ULOADER_API UVrmLoaderComponent : public UActorComponent
 
 	UPROPERTY()
 	UVrmAssetListObject *AssetList = nullptr;
-	mutable bool bResultQueue = false;
+
+	// async load. game thread time per frame for creating the assets
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "VRM4U")
+	float FinalizeBudgetMs = 8.f;
 
 public:
 	void OnRegister() override;
@@ -62,13 +66,28 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "VRM4U", meta = (DynamicOutputParam = "OutVrmAsset"))
 	bool LoadVRMFile(const UVrmAssetListObject *InVrmAsset, UVrmAssetListObject *&OutVrmAsset, FString filepath);
 
+	// file read, parse and texture decode on a worker thread. the assets are created over the next frames.
+	// OnFinishLoad is called with the result, or null on failure. a running load is canceled
 	UFUNCTION(BlueprintCallable, Category = "VRM4U", meta = (DynamicOutputParam = "OutVrmAsset"))
 	bool LoadVRMFileAsync(const UVrmAssetListObject *InVrmAsset, FString filepath);
 
+	// no OnFinishLoad for a canceled load
+	UFUNCTION(BlueprintCallable, Category = "VRM4U")
+	void CancelLoadVRMFileAsync();
+
+	UFUNCTION(BlueprintPure, Category = "VRM4U")
+	bool IsLoadingVRMFile() const;
+
+	// 0-1
+	UFUNCTION(BlueprintPure, Category = "VRM4U")
+	float GetLoadProgress() const;
+
 	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction *ThisTickFunction) override;
 
 
 private:
+	TSharedPtr<FVrmLoadTask> LoadTask;
+
 	/** Native handlers that get registered with the actual FCoreDelegates, and then proceed to broadcast to the delegates above */
 	/*
 	void ApplicationWillDeactivateDelegate_Handler() { ApplicationWillDeactivateDelegate.Broadcast(); }
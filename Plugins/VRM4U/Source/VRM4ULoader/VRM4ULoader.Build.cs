@@ -35,6 +35,7 @@ public class VRM4ULoader : ModuleRules
                 "Engine",
                 "RHI",
                 "RenderCore",
+                "Json",
                 "AnimGraphRuntime",
                 "ProceduralMeshComponent",
                 "VRM4U",